@@ -0,0 +1,57 @@
+/* Benchmark hooks for the simulation models.  When a model is compiled with
+   -DBENCH, the hooks time the run, count the events executed and the peak
+   queue length, and at the end write one comma-separated line
+       events,seconds,events_per_sec,ns_per_event,peak_queue,peak_rss_kb
+   to standard error (collected by bench.sh at the top of the repository).
+   Without -DBENCH the hooks expand to nothing.  This file (named bench.h)
+   should be included in the model by executing
+       #include "bench.h"
+   and the hooks used as
+       BENCH_START();   before the first event,
+       BENCH_EVENT();   once per event executed,
+       BENCH_QUEUE(n);  whenever a queue grows to length n, and
+       BENCH_STOP();    after the last event. */
+
+#ifdef BENCH
+
+#include <stdio.h>
+#include <time.h>
+#include <sys/resource.h>
+
+static double bench_time_start;
+static long   bench_num_events, bench_peak_queue;
+
+static double bench_clock(void)  /* Return a monotonic time in seconds. */
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+}
+
+static void bench_stop(void)  /* Write the benchmark line. */
+{
+    double        seconds;
+    struct rusage usage;
+
+    seconds = bench_clock() - bench_time_start;
+    getrusage(RUSAGE_SELF, &usage);
+    fprintf(stderr, "%ld,%.6f,%.0f,%.2f,%ld,%ld\n", bench_num_events, seconds,
+            bench_num_events / seconds, 1.0e+9 * seconds / bench_num_events,
+            bench_peak_queue, (long) usage.ru_maxrss);
+}
+
+#define BENCH_START()  (bench_time_start = bench_clock())
+#define BENCH_EVENT()  (++bench_num_events)
+#define BENCH_QUEUE(n) (bench_peak_queue = (n) > bench_peak_queue ? \
+                                           (n) : bench_peak_queue)
+#define BENCH_STOP()   bench_stop()
+
+#else
+
+#define BENCH_START()
+#define BENCH_EVENT()
+#define BENCH_QUEUE(n)
+#define BENCH_STOP()
+
+#endif
@@ -22,7 +22,14 @@
    3. To get the current (most recently used) integer in the sequence being
       generated for stream "stream" into the long variable zget, execute
           zget = lcgrandgt(stream);
-      where lcgrandgt is a long function. */
+      where lcgrandgt is a long function.
+
+   A fourth function, lcgrandz, generates from a seed held by the caller
+   rather than from one of the 100 built-in streams, so that several threads
+   can each carry their own stream:
+          u = lcgrandz(&z);
+   where z is a long initialized, e.g., by z = lcgrandgt(stream), and updated
+   in place. */
 
 /* Define the constants. */
 
@@ -54,11 +61,12 @@ static long zrng[] =
 
 /* Generate the next random number. */
 
-float lcgrand(int stream)
+float lcgrandz(long *zp)  /* Generate the next random number from the
+                             caller-held seed *zp, and update *zp. */
 {
     long zi, lowprd, hi31;
 
-    zi     = zrng[stream];
+    zi     = *zp;
     lowprd = (zi & 65535) * MULT1;
     hi31   = (zi >> 16) * MULT1 + (lowprd >> 16);
     zi     = ((lowprd & 65535) - MODLUS) +
@@ -69,11 +77,18 @@ float lcgrand(int stream)
     zi     = ((lowprd & 65535) - MODLUS) +
              ((hi31 & 32767) << 16) + (hi31 >> 15);
     if (zi < 0) zi += MODLUS;
-    zrng[stream] = zi;
+    *zp = zi;
     return (zi >> 7 | 1) / 16777216.0;
 }
 
 
+float lcgrand(int stream)  /* Generate the next random number from stream
+                              "stream". */
+{
+    return lcgrandz(&zrng[stream]);
+}
+
+
 void lcgrandst (long zset, int stream) /* Set the current zrng for stream
                                           "stream" to zset. */
 {
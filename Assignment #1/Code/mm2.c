@@ -3,11 +3,54 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 #include "lcgrand.h"  /* Header file for random-number generator. */
+#include "bench.h"    /* Header file for benchmark hooks. */
+#include "instr.h"    /* Header file for instrumentation hooks. */
+#include "results.h"  /* Header file for machine-readable results. */
+#include "replay.h"   /* Header file for trace-driven input. */
+#include "dist.h"     /* Header file for service-time distributions. */
 
+#ifndef Q_LIMIT
 #define Q_LIMIT 5000  /* Limit on queue length. */
+#endif
 #define BUSY      1  /* Mnemonics for server's being busy */
 #define IDLE      0  /* and idle. */
+#define CHECKPOINT_FILE    "mm2.ckpt"      /* Snapshot of an unfinished run, */
+#define CHECKPOINT_TMP     "mm2.ckpt.tmp"  /* and the file it is written to
+                                              before replacing it. */
+#define CHECKPOINT_MAGIC   0x504b434dUL    /* "MCKP" in little-endian order. */
+#define CHECKPOINT_VERSION 5
+#define CHECKPOINT_EVENTS  65536  /* Events between looks at the clock. */
+
+struct checkpoint {  /* Snapshot header, followed by the num_in_q1 and
+                        num_in_q2 entries of queue1 and queue2, the num_in_q2
+                        entries of ipa_arrival2, and, if results is 1, the
+                        machine-readable results (see results.h).  size is
+                        that of the header, which is larger in a build with
+                        -DREPLAY, so that a snapshot from another build is
+                        rejected. */
+    uint32_t magic, version, q_limit, replication, results, size;
+    float    mean_interarrival, service_time1, service_time2;
+    int32_t  time_limit, next_event_type, num_custs_delayed1,
+             num_custs_delayed2, num_in_q1, num_in_q2, server1_status,
+             server2_status;
+    float    area_num_in_q1, area_num_in_q2, area_server_status1,
+             area_server_status2, sim_time, time_last_event,
+             time_next_event[4], total_of_delays1, total_of_delays2;
+    int32_t  service_kind[3], service_k[3];
+    uint64_t service_checksum[3];
+    double   service_shape[3], service_mean[3], ipa_completion1[3],
+             ipa_completion2[3], ipa_delays1[3], ipa_delays2[3];
+    int64_t  seed, outfile_offset;
+#ifdef REPLAY
+    int64_t  replay_arrival_next, replay_service_next[3];
+    double   replay_time_last_arrival;
+#endif
+};
 
 int   next_event_type, num_custs_delayed1, num_custs_delayed2, time_limit, num_events,
       num_in_q1, num_in_q2, server1_status, server2_status;
@@ -16,6 +59,16 @@ float area_num_in_q1, area_num_in_q2, area_server_status1, area_server_status2,
       sim_time, queue1[Q_LIMIT + 1], queue2[Q_LIMIT + 1], time_last_event, time_next_event[4],
       total_of_delays1, total_of_delays2;
       
+float checkpoint_interval;
+struct dist service_dist[3];
+
+/* Derivatives with respect to service_time1 (index 1) and service_time2
+   (index 2), by infinitesimal perturbation analysis: of the completion time
+   of the service in progress at each server, of the arrival time at queue 2
+   of each customer in it, and of the total delays in each queue. */
+
+double ipa_completion1[3], ipa_completion2[3], ipa_arrival2[Q_LIMIT + 1][3],
+       ipa_delays1[3], ipa_delays2[3];
 FILE  *infile, *outfile;
 
 void  initialize(void);
@@ -26,36 +79,109 @@ void  depart(void);
 void  report(void);
 void  update_time_avg_stats(void);
 float expon(float mean);
+float service(int station);
+void  ipa_start(double *completion, const double *start, int station,
+                float s);
+void  ipa_report(double *total, int num_custs);
+int   ipa_available(int station);
+void  checkpoint(int replication);
+int   restart(int *replication);
+int   same_service(struct checkpoint *c, int station);
+double wall_time(void);
 
 int main()  /* Main function. */
 {
-    /* Open input and output files. */
+    char   keyword[16];
+    int    first_replication, restarted, station;
+    long   num_events_since_check;
+    double time_last_checkpoint;
+
+    /* Open input file. */
 
     infile  = fopen("mm2.in1",  "r");
-    outfile = fopen("mm2.new.out", "w");
 
     /* Specify the number of events for the timing function. */
 
     num_events = 3;
 
-    /* Read input parameters. */
+    /* Map the trace, when replaying one.  Successive replications continue
+       through the trace, each starting at the next customer in it. */
 
-    fscanf(infile, "%f %f %f %d", &mean_interarrival, &service_time1, &service_time2, &time_limit);
-           
+    REPLAY_OPEN("mm2.rep", 2);
 
-    /* Write report heading and input parameters. */
+    /* Read input parameters.  An optional fifth parameter is the interval, in
+       seconds of wall-clock time, at which the state of the run is saved to
+       a checkpoint file. */
 
-    fprintf(outfile, "Double-server queueing system\n\n");
-    fprintf(outfile, "Mean interarrival time%11.3f minutes\n\n",
-            mean_interarrival);
-    fprintf(outfile, "Mean service time for server 1%16.3f minutes\n\n", service_time1);
-    fprintf(outfile, "Mean service time for server 2%16.3f minutes\n\n", service_time2);
-    fprintf(outfile, "Time limit%14d\n\n", time_limit);
+    checkpoint_interval = 0.0;
+    fscanf(infile, "%f %f %f %d %f", &mean_interarrival, &service_time1, &service_time2, &time_limit,
+           &checkpoint_interval);
 
-    /* Initialize the simulation. */
+    /* Service times are exponential unless lines of the form
+       "service <server> <distribution>" follow, with the distribution written
+       as described in dist.h and taking its mean from the first line.  Any
+       other line is an error, rather than being silently ignored. */
 
-for(int i = 0; i < 10; i++) {    
-	initialize();
+    dist_expon(&service_dist[1], service_time1);
+    dist_expon(&service_dist[2], service_time2);
+    while (fscanf(infile, " %15s", keyword) == 1) {
+        if (strcmp(keyword, "service") != 0) {
+            fprintf(stderr, "Unknown input line \"%s\"\n", keyword);
+            exit(1);
+        }
+        if (fscanf(infile, "%d", &station) != 1 || station < 1 ||
+            station > 2) {
+            fprintf(stderr, "Invalid server in service line\n");
+            exit(1);
+        }
+        if (dist_read(infile, &service_dist[station],
+                      station == 1 ? service_time1 : service_time2) != 0) {
+            fprintf(stderr, "Invalid service distribution for server %d\n",
+                    station);
+            exit(1);
+        }
+    }
+
+    /* If an earlier run with these parameters was interrupted, resume it from
+       its checkpoint, appending to its report.  Otherwise, open the output
+       file and write the report heading and input parameters. */
+
+    restarted = restart(&first_replication);
+    if (!restarted) {
+        first_replication = 0;
+        outfile = fopen("mm2.new.out", "w");
+        fprintf(outfile, "Double-server queueing system\n\n");
+        fprintf(outfile, "Mean interarrival time%11.3f minutes\n\n",
+                mean_interarrival);
+        fprintf(outfile, "Mean service time for server 1%16.3f minutes\n\n", service_time1);
+        fprintf(outfile, "Mean service time for server 2%16.3f minutes\n\n", service_time2);
+        fprintf(outfile, "Time limit%14d\n\n", time_limit);
+        for (station = 1; station <= 2; ++station)
+            if (service_dist[station].kind != DIST_EXPON) {
+                char description[64];
+
+                dist_describe(&service_dist[station], description,
+                              sizeof(description));
+                fprintf(outfile, "Service distribution for server %d  %s\n\n",
+                        station, description);
+            }
+        REPLAY_REPORT(outfile, "mm2.rep");
+        RESULTS_OPEN("mm2", 1);
+    }
+
+    /* Initialize the simulation, unless its state was restored from the
+       checkpoint. */
+
+BENCH_START();
+num_events_since_check = 0;
+time_last_checkpoint   = wall_time();
+for(int i = first_replication; i < 10; i++) {    
+	if (restarted)
+		restarted = 0;
+	else {
+		RESULTS_START(i);
+		initialize();
+	}
 
 
 	/* Run the simulation while more time is needed. */
@@ -64,14 +190,20 @@ for(int i = 0; i < 10; i++) {
 
 		/* Determine the next event. */
 
+		INSTR_BEGIN(INSTR_TIMING);
 		timing();
+		INSTR_END(INSTR_TIMING);
+		BENCH_EVENT();
 
 		/* Update time-average statistical accumulators. */
 
+		INSTR_BEGIN(INSTR_STATS);
 		update_time_avg_stats();
+		INSTR_END(INSTR_STATS);
 
 		/* Invoke the appropriate event function. */
 
+		INSTR_BEGIN(INSTR_EVENT(next_event_type));
 		switch (next_event_type) {
 			case 1:
 				arrive();
@@ -83,6 +215,18 @@ for(int i = 0; i < 10; i++) {
 				depart();
 				break;
 		}
+		INSTR_END(INSTR_EVENT(next_event_type));
+
+		/* Save the state when the checkpoint interval has elapsed. */
+
+		if (checkpoint_interval > 0.0 &&
+		    ++num_events_since_check == CHECKPOINT_EVENTS) {
+			num_events_since_check = 0;
+			if (wall_time() - time_last_checkpoint >= checkpoint_interval) {
+				checkpoint(i);
+				time_last_checkpoint = wall_time();
+			}
+		}
 	}
 
     /* Invoke the report generator and end the simulation. */
@@ -90,10 +234,19 @@ for(int i = 0; i < 10; i++) {
     report();
     
 }
+BENCH_STOP();
 
+    REPLAY_CLOSE();
+    RESULTS_CLOSE();
+    dist_free(&service_dist[1]);
+    dist_free(&service_dist[2]);
     fclose(infile);
     fclose(outfile);
 
+    /* The run is complete, so its checkpoint is no longer needed. */
+
+    remove(CHECKPOINT_FILE);
+
     return 0;
 }
 
@@ -122,12 +275,18 @@ void initialize(void)  /* Initialization function. */
     area_num_in_q2      = 0.0;
     area_server_status1 = 0.0;
     area_server_status2 = 0.0;
+    memset(ipa_delays1, 0, sizeof(ipa_delays1));
+    memset(ipa_delays2, 0, sizeof(ipa_delays2));
 
     /* Initialize event list.  Since no customers are present, the departure
        (service completion) event is eliminated from consideration, as is the
-       queue change operation. */
+       queue change operation.  When replaying, the first customer is the next
+       one in the trace, whose services are the next to be used, so that each
+       customer keeps its own service times even though those left in the
+       system at the end of the previous replication never used theirs. */
 
-    time_next_event[1] = sim_time + expon(mean_interarrival);
+    REPLAY_ALIGN();
+    time_next_event[1] = sim_time + REPLAY_ARRIVAL(expon(mean_interarrival));
     time_next_event[2] = 1.0e+30;
     time_next_event[3] = 1.0e+30;
 }
@@ -151,8 +310,10 @@ void timing(void)  /* Timing function. */
 
     if (next_event_type == 0) {
 
-        /* The event list is empty, so stop the simulation. */
+        /* The event list is empty, so stop the simulation.  When replaying,
+           this means that the trace has run out of arrivals. */
 
+        REPLAY_EXHAUSTED(outfile, sim_time);
         fprintf(outfile, "\nEvent list empty at time %f", sim_time);
         exit(1);
     }
@@ -164,11 +325,12 @@ void timing(void)  /* Timing function. */
 
 void arrive(void)  /* Arrival event function. */
 {
-    float delay;
+    static const double zero[3] = {0.0, 0.0, 0.0};
+    float  delay, s;
 
     /* Schedule next arrival. */
 
-    time_next_event[1] = sim_time + expon(mean_interarrival);
+    time_next_event[1] = sim_time + REPLAY_ARRIVAL(expon(mean_interarrival));
 
     /* Check to see whether server 1 is busy. */
 
@@ -193,6 +355,7 @@ void arrive(void)  /* Arrival event function. */
            arriving customer at the (new) end of time_arrival. */
 
         queue1[num_in_q1] = sim_time;
+        BENCH_QUEUE(num_in_q1);
     }
 
     else {
@@ -209,9 +372,12 @@ void arrive(void)  /* Arrival event function. */
         ++num_custs_delayed1;
         server1_status = BUSY;
 
-        /* Schedule a a queue change event. */
+        /* Schedule a a queue change event.  The service starts at the
+           customer's arrival, which does not depend on the service times. */
 
-        time_next_event[2] = sim_time + expon(service_time1);
+        s                  = REPLAY_SERVICE(1, service(1));
+        time_next_event[2] = sim_time + s;
+        ipa_start(ipa_completion1, zero, 1, s);
     }
     
     //printf("ARRIVAL: %d in queue 1 and %d in queue 2, SERVER 1 STATUS: %d and SERVER 2 STATUS: %d\n", num_in_q1, num_in_q2, server1_status, server2_status);
@@ -219,8 +385,14 @@ void arrive(void)  /* Arrival event function. */
 
 void change(void)  /* Queue change event function. */
 {
-    int   i;
-    float delay;
+    int    i, j;
+    float  delay, s;
+    double arrival2[3];
+
+    /* The customer leaving server 1 arrives at queue 2 now, at the completion
+       time of its service. */
+
+    memcpy(arrival2, ipa_completion1, sizeof(arrival2));
 
     /* Check to see whether the queue is empty. */
 
@@ -246,13 +418,20 @@ void change(void)  /* Queue change event function. */
         delay            = sim_time - queue1[1];
         total_of_delays1 += delay;
 
-        /* Increment the number of customers delayed, and schedule queue change. */
+        /* Increment the number of customers delayed, and schedule queue change.
+           The service starts at the completion just made, so its derivatives
+           carry over to the delay and the new completion. */
 
         ++num_custs_delayed1;
-        time_next_event[2] = sim_time + expon(service_time1);
+        s                  = REPLAY_SERVICE(1, service(1));
+        time_next_event[2] = sim_time + s;
+        for (j = 1; j <= 2; ++j)
+            ipa_delays1[j] += ipa_completion1[j];
+        ipa_start(ipa_completion1, ipa_completion1, 1, s);
 
         /* Move each customer in queue (if any) up one place. */
 
+        INSTR_SHIFT(num_in_q1);
         for (i = 1; i <= num_in_q1; ++i)
             queue1[i] = queue1[i + 1];
     }
@@ -281,6 +460,8 @@ void change(void)  /* Queue change event function. */
            arriving customer at the (new) end of time_arrival. */
 
         queue2[num_in_q2] = sim_time;
+        memcpy(ipa_arrival2[num_in_q2], arrival2, sizeof(arrival2));
+        BENCH_QUEUE(num_in_q2);
     }
 
     else {
@@ -299,7 +480,9 @@ void change(void)  /* Queue change event function. */
 
         /* Schedule a queue departure event. */
 
-        time_next_event[3] = sim_time + expon(service_time2);
+        s                  = REPLAY_SERVICE(2, service(2));
+        time_next_event[3] = sim_time + s;
+        ipa_start(ipa_completion2, arrival2, 2, s);
     }
     
     
@@ -312,8 +495,8 @@ void change(void)  /* Queue change event function. */
 
 void depart(void)  /* Departure event function. */
 {
-    int   i;
-    float delay;
+    int   i, j;
+    float delay, s;
 
     /* Check to see whether the queue is empty. */
 
@@ -342,12 +525,20 @@ void depart(void)  /* Departure event function. */
         /* Increment the number of customers delayed, and schedule departure. */
 
         ++num_custs_delayed2;
-        time_next_event[3] = sim_time + expon(service_time2);
+        s                  = REPLAY_SERVICE(2, service(2));
+        time_next_event[3] = sim_time + s;
+        for (j = 1; j <= 2; ++j)
+            ipa_delays2[j] += ipa_completion2[j] - ipa_arrival2[1][j];
+        ipa_start(ipa_completion2, ipa_completion2, 2, s);
 
         /* Move each customer in queue (if any) up one place. */
 
-        for (i = 1; i <= num_in_q2; ++i)
+        INSTR_SHIFT(num_in_q2);
+        for (i = 1; i <= num_in_q2; ++i) {
             queue2[i] = queue2[i + 1];
+            memcpy(ipa_arrival2[i], ipa_arrival2[i + 1],
+                   sizeof(ipa_arrival2[i]));
+        }
     }
     
         //printf("DEPARTURE: %d in queue 1 and %d in queue 2, SERVER 1 STATUS: %d and SERVER 2 STATUS: %d\n", num_in_q1, num_in_q2, server1_status, server2_status);
@@ -372,6 +563,42 @@ void report(void)  /* Report generator function. */
     fprintf(outfile, "Server 2 utilization%15.3f\n\n",
             area_server_status2 / sim_time);
     fprintf(outfile, "Time simulation ended%12.3f minutes", sim_time);
+
+    /* Write the derivatives of the average delays with respect to the mean
+       service times, where ipa_available() says they have a meaning.  The
+       rows are labelled apart from the averages themselves, so that a reader
+       of the report looking for a label finds one value. */
+
+    fprintf(outfile, "\n\nDelay derivatives (IPA)      d/d service time 1");
+    fprintf(outfile, "   d/d service time 2");
+    fprintf(outfile, "\n\nd(Average delay in queue 1)");
+    ipa_report(ipa_delays1, num_custs_delayed1);
+    fprintf(outfile, "\n\nd(Average delay in queue 2)");
+    ipa_report(ipa_delays2, num_custs_delayed2);
+    INSTR_REPORT(outfile);
+
+    /* Write the parameters and measures as a machine-readable row. */
+
+    RESULTS_REAL("mean_interarrival", mean_interarrival);
+    RESULTS_REAL("service_time1", service_time1);
+    RESULTS_REAL("service_time2", service_time2);
+    RESULTS_INT("time_limit", time_limit);
+    RESULTS_REAL("avg_delay_in_queue1", total_of_delays1 / num_custs_delayed1);
+    RESULTS_REAL("avg_delay_in_queue2", total_of_delays2 / num_custs_delayed2);
+    RESULTS_REAL("avg_num_in_queue1", area_num_in_q1 / sim_time);
+    RESULTS_REAL("avg_num_in_queue2", area_num_in_q2 / sim_time);
+    RESULTS_REAL("server1_utilization", area_server_status1 / sim_time);
+    RESULTS_REAL("server2_utilization", area_server_status2 / sim_time);
+    RESULTS_REAL("time_end", sim_time);
+    RESULTS_REAL("d_delay1_d_service_time1", !ipa_available(1) ? NAN :
+                 ipa_delays1[1] / num_custs_delayed1);
+    RESULTS_REAL("d_delay1_d_service_time2", !ipa_available(2) ? NAN :
+                 ipa_delays1[2] / num_custs_delayed1);
+    RESULTS_REAL("d_delay2_d_service_time1", !ipa_available(1) ? NAN :
+                 ipa_delays2[1] / num_custs_delayed2);
+    RESULTS_REAL("d_delay2_d_service_time2", !ipa_available(2) ? NAN :
+                 ipa_delays2[2] / num_custs_delayed2);
+    RESULTS_ROW();
 }
 
 
@@ -400,12 +627,270 @@ void update_time_avg_stats(void)  /* Update area accumulators for time-average
 
 float expon(float mean)  /* Exponential variate generation function. */
 {
+    float x;
+
     /* Return an exponential random variate with mean "mean". */
 
-    return -mean * log(lcgrand(1));
+    INSTR_RNG_BEGIN();
+    x = -mean * log(lcgrand(1));
+    INSTR_RNG_END(1);
+    return x;
 }
 
 
+float service(int station)  /* Service-time variate generation function. */
+{
+    float x;
+
+    /* Exponential service times still come from expon(), so that default
+       runs draw exactly the variates they always have. */
 
+    if (service_dist[station].kind == DIST_EXPON)
+        return expon(service_dist[station].mean);
+    INSTR_RNG_BEGIN();
+    x = dist_sample(&service_dist[station], 1);
+    INSTR_RNG_END(service_dist[station].num_uniforms);
+    return x;
+}
 
 
+
+
+
+
+
+void ipa_start(double *completion, const double *start, int station,
+               float s)  /* Set the derivatives of the completion time of a
+                            service s at station from those of its start. */
+{
+    int j;
+
+    /* The completion is the start plus s, and s is its distribution's mean
+       times a variate that does not depend on the mean, so ds/dmean is
+       s / mean.  Where that does not hold, the derivatives of s are taken as
+       zero, and are not reported. */
+
+    for (j = 1; j <= 2; ++j)
+        completion[j] = start[j];
+    if (ipa_available(station))
+        completion[station] += s / (station == 1 ? service_time1 :
+                                                   service_time2);
+}
+
+
+void ipa_report(double *total, int num_custs)  /* Write the derivatives of
+                                                  an average delay. */
+{
+    int j;
+
+    for (j = 1; j <= 2; ++j)
+        if (!ipa_available(j))
+            fprintf(outfile, "%21s", "n/a");
+        else
+            fprintf(outfile, "%21.3f", total[j] / num_custs);
+}
+
+
+int ipa_available(int station)  /* Return 1 if the service times at station
+                                   are their mean times a variate that does
+                                   not depend on it, or 0. */
+{
+    /* This fails for an empirical distribution, whose mean is not a
+       parameter, and for service times replayed from a trace. */
+
+#ifdef REPLAY
+    (void) station;
+    return 0;
+#else
+    return service_dist[station].kind != DIST_EMPIRICAL;
+#endif
+}
+
+
+void checkpoint(int replication)  /* Checkpoint function.  Saves the complete
+                                     state of the run, so that it can be resumed
+                                     exactly where it was. */
+{
+    struct checkpoint c;
+    FILE             *file;
+    int               s;
+
+    /* The report written so far is kept, up to the current offset. */
+
+    fflush(outfile);
+
+    memset(&c, 0, sizeof(c));
+    c.magic               = CHECKPOINT_MAGIC;
+    c.version             = CHECKPOINT_VERSION;
+    c.q_limit             = Q_LIMIT;
+    c.replication         = replication;
+    c.results             = RESULTS_SAVED;
+    c.size                = sizeof(c);
+    c.mean_interarrival   = mean_interarrival;
+    c.service_time1       = service_time1;
+    c.service_time2       = service_time2;
+    c.time_limit          = time_limit;
+    c.next_event_type     = next_event_type;
+    c.num_custs_delayed1  = num_custs_delayed1;
+    c.num_custs_delayed2  = num_custs_delayed2;
+    c.num_in_q1           = num_in_q1;
+    c.num_in_q2           = num_in_q2;
+    c.server1_status      = server1_status;
+    c.server2_status      = server2_status;
+    c.area_num_in_q1      = area_num_in_q1;
+    c.area_num_in_q2      = area_num_in_q2;
+    c.area_server_status1 = area_server_status1;
+    c.area_server_status2 = area_server_status2;
+    c.sim_time            = sim_time;
+    c.time_last_event     = time_last_event;
+    memcpy(c.time_next_event, time_next_event, sizeof(time_next_event));
+    c.total_of_delays1    = total_of_delays1;
+    c.total_of_delays2    = total_of_delays2;
+    for (s = 1; s <= 2; ++s) {
+        c.service_kind[s]  = service_dist[s].kind;
+        c.service_k[s]     = service_dist[s].k;
+        c.service_shape[s] = service_dist[s].shape;
+        c.service_mean[s]  = service_dist[s].mean;
+        c.service_checksum[s] = dist_checksum(&service_dist[s]);
+    }
+    memcpy(c.ipa_completion1, ipa_completion1, sizeof(ipa_completion1));
+    memcpy(c.ipa_completion2, ipa_completion2, sizeof(ipa_completion2));
+    memcpy(c.ipa_delays1, ipa_delays1, sizeof(ipa_delays1));
+    memcpy(c.ipa_delays2, ipa_delays2, sizeof(ipa_delays2));
+    c.seed                = lcgrandgt(1);
+    c.outfile_offset      = ftell(outfile);
+#ifdef REPLAY
+    c.replay_arrival_next      = replay_arrival_next;
+    c.replay_service_next[1]   = replay_service_next[1];
+    c.replay_service_next[2]   = replay_service_next[2];
+    c.replay_time_last_arrival = replay_time_last_arrival;
+#endif
+
+    /* Write the snapshot to a temporary file and then rename it over the
+       previous one, so that an interruption while writing leaves the previous
+       snapshot intact. */
+
+    file = fopen(CHECKPOINT_TMP, "wb");
+    if (file == NULL)
+        return;
+    fwrite(&c, sizeof(c), 1, file);
+    fwrite(&queue1[1], sizeof(float), num_in_q1, file);
+    fwrite(&queue2[1], sizeof(float), num_in_q2, file);
+    fwrite(&ipa_arrival2[1], sizeof(ipa_arrival2[1]), num_in_q2, file);
+    RESULTS_SAVE(file);
+    if (fflush(file) != 0 || fsync(fileno(file)) != 0) {
+        fclose(file);
+        remove(CHECKPOINT_TMP);
+        return;
+    }
+    fclose(file);
+    rename(CHECKPOINT_TMP, CHECKPOINT_FILE);
+}
+
+
+int restart(int *replication)  /* Restart function.  Restores the state saved
+                                  by checkpoint(), if there is a snapshot for
+                                  the current parameters, and returns 1, or
+                                  returns 0. */
+{
+    struct checkpoint c;
+    FILE             *file;
+    int               ok;
+
+    file = fopen(CHECKPOINT_FILE, "rb");
+    if (file == NULL)
+        return 0;
+    ok = fread(&c, sizeof(c), 1, file) == 1 &&
+         c.magic == CHECKPOINT_MAGIC && c.version == CHECKPOINT_VERSION &&
+         c.size == sizeof(c) &&
+         c.q_limit == Q_LIMIT && c.mean_interarrival == mean_interarrival &&
+         c.service_time1 == service_time1 &&
+         c.service_time2 == service_time2 && c.time_limit == time_limit &&
+         same_service(&c, 1) && same_service(&c, 2) &&
+         c.num_in_q1 >= 0 && c.num_in_q1 <= Q_LIMIT &&
+         c.num_in_q2 >= 0 && c.num_in_q2 <= Q_LIMIT &&
+         fread(&queue1[1], sizeof(float), c.num_in_q1, file) ==
+         (size_t) c.num_in_q1 &&
+         fread(&queue2[1], sizeof(float), c.num_in_q2, file) ==
+         (size_t) c.num_in_q2 &&
+         fread(&ipa_arrival2[1], sizeof(ipa_arrival2[1]), c.num_in_q2, file) ==
+         (size_t) c.num_in_q2 &&
+         c.results == RESULTS_SAVED && RESULTS_LOAD(file);
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "Ignoring %s, which is not a checkpoint of this run\n",
+                CHECKPOINT_FILE);
+        return 0;
+    }
+
+    /* Cut the report back to where it was when the snapshot was taken. */
+
+    outfile = fopen("mm2.new.out", "r+");
+    if (outfile == NULL || ftruncate(fileno(outfile), c.outfile_offset) != 0) {
+        fprintf(stderr, "Cannot resume the report mm2.new.out\n");
+        exit(3);
+    }
+    fseek(outfile, c.outfile_offset, SEEK_SET);
+
+    /* Do the same with the machine-readable results, whose rows so far and
+       the start of the row of the current replication were restored with the
+       rest of the snapshot. */
+
+    RESULTS_REOPEN("mm2", 1);
+
+    *replication        = c.replication;
+    next_event_type     = c.next_event_type;
+    num_custs_delayed1  = c.num_custs_delayed1;
+    num_custs_delayed2  = c.num_custs_delayed2;
+    num_in_q1           = c.num_in_q1;
+    num_in_q2           = c.num_in_q2;
+    server1_status      = c.server1_status;
+    server2_status      = c.server2_status;
+    area_num_in_q1      = c.area_num_in_q1;
+    area_num_in_q2      = c.area_num_in_q2;
+    area_server_status1 = c.area_server_status1;
+    area_server_status2 = c.area_server_status2;
+    sim_time            = c.sim_time;
+    time_last_event     = c.time_last_event;
+    memcpy(time_next_event, c.time_next_event, sizeof(time_next_event));
+    total_of_delays1    = c.total_of_delays1;
+    total_of_delays2    = c.total_of_delays2;
+    memcpy(ipa_completion1, c.ipa_completion1, sizeof(ipa_completion1));
+    memcpy(ipa_completion2, c.ipa_completion2, sizeof(ipa_completion2));
+    memcpy(ipa_delays1, c.ipa_delays1, sizeof(ipa_delays1));
+    memcpy(ipa_delays2, c.ipa_delays2, sizeof(ipa_delays2));
+    lcgrandst(c.seed, 1);
+#ifdef REPLAY
+    replay_arrival_next      = c.replay_arrival_next;
+    replay_service_next[1]   = c.replay_service_next[1];
+    replay_service_next[2]   = c.replay_service_next[2];
+    replay_time_last_arrival = c.replay_time_last_arrival;
+#endif
+    return 1;
+}
+
+
+int same_service(struct checkpoint *c, int station)  /* Return 1 if the
+                                                        snapshot has the same
+                                                        service distribution
+                                                        for station, or 0. */
+{
+    /* The checksum tells apart empirical distributions with the same number
+       of points and mean but different points. */
+
+    return c->service_kind[station]  == service_dist[station].kind &&
+           c->service_k[station]     == service_dist[station].k &&
+           c->service_shape[station] == service_dist[station].shape &&
+           c->service_mean[station]  == service_dist[station].mean &&
+           c->service_checksum[station] ==
+           dist_checksum(&service_dist[station]);
+}
+
+
+double wall_time(void)  /* Return the wall-clock time in seconds. */
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1.0e-9 * t.tv_nsec;
+}
@@ -0,0 +1,523 @@
+/* External definitions for double-server queueing system with what-if
+   branches forked from a warmed-up state. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+#ifndef Q_LIMIT
+#define Q_LIMIT 5000  /* Limit on queue length. */
+#endif
+#define BUSY      1  /* Mnemonics for server's being busy */
+#define IDLE      0  /* and idle. */
+#define BRANCH_LIMIT 1000  /* Limit on number of branches. */
+
+struct branch {  /* Parameters of one continuation after the warm-up. */
+    float mean_interarrival, service_time1, service_time2;
+    int   stream;
+};
+
+struct outcome {  /* Measures of performance of one continuation, sent back
+                     from its process through a pipe. */
+    int   overflow, num_custs_delayed1, num_custs_delayed2;
+    float avg_delay1, avg_delay2, avg_num_in_q1, avg_num_in_q2, utilization1,
+          utilization2;
+};
+
+int   next_event_type, num_custs_delayed1, num_custs_delayed2, time_limit,
+      num_events, num_in_q1, num_in_q2, server1_status, server2_status,
+      overflow, max_children, num_branches;
+float area_num_in_q1, area_num_in_q2, area_server_status1, area_server_status2,
+      mean_interarrival, service_time1, service_time2, sim_time,
+      queue1[Q_LIMIT + 1], queue2[Q_LIMIT + 1], time_last_event,
+      time_next_event[4], total_of_delays1, total_of_delays2, time_warmup;
+int   stream;
+struct branch  branches[BRANCH_LIMIT + 1];
+struct outcome outcomes[BRANCH_LIMIT + 1];
+FILE  *infile, *outfile;
+
+void  initialize(void);
+void  run(float time_end);
+void  reset_stats(void);
+void  fork_branches(void);
+void  continue_branch(int b, int fd);
+void  collect(pid_t pid, pid_t children[], int fds[]);
+void  timing(void);
+void  arrive(void);
+void  change(void);
+void  depart(void);
+void  report(void);
+void  update_time_avg_stats(void);
+float expon(float mean);
+
+
+int main()  /* Main function. */
+{
+    int b;
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm2fork.in",  "r");
+    outfile = fopen("mm2fork.out", "w");
+
+    /* Specify the number of events for the timing function. */
+
+    num_events = 3;
+
+    /* Read input parameters: those of mm2.in1, the warm-up time, the number of
+       branches to run at once (0 means one per online processor), the number
+       of branches, and for each branch its mean interarrival time, mean
+       service times and random-number stream (0 to continue on the stream of
+       the warm-up, which gives common random numbers across branches). */
+
+    fscanf(infile, "%f %f %f %d %f %d %d", &mean_interarrival, &service_time1,
+           &service_time2, &time_limit, &time_warmup, &max_children,
+           &num_branches);
+    if (max_children <= 0)
+        max_children = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_branches > BRANCH_LIMIT)
+        num_branches = BRANCH_LIMIT;
+    for (b = 1; b <= num_branches; ++b)
+        fscanf(infile, "%f %f %f %d", &branches[b].mean_interarrival,
+               &branches[b].service_time1, &branches[b].service_time2,
+               &branches[b].stream);
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Double-server queueing system with what-if");
+    fprintf(outfile, " branches\n\n");
+    fprintf(outfile, "Mean interarrival time%11.3f minutes\n\n",
+            mean_interarrival);
+    fprintf(outfile, "Mean service time for server 1%11.3f minutes\n\n",
+            service_time1);
+    fprintf(outfile, "Mean service time for server 2%11.3f minutes\n\n",
+            service_time2);
+    fprintf(outfile, "Warm-up time%21.3f minutes\n\n", time_warmup);
+    fprintf(outfile, "Time limit%23d minutes\n\n", time_limit);
+    fprintf(outfile, "Number of branches%15d\n\n", num_branches);
+
+    /* Simulate the warm-up once, with the base parameters on stream 1. */
+
+    stream = 1;
+    initialize();
+    run(time_warmup);
+    if (overflow) {
+        fprintf(outfile, "Overflow of queue %d at time %.3f in the warm-up\n",
+                overflow, sim_time);
+        exit(2);
+    }
+    fprintf(outfile, "At the end of the warm-up, %d in queue 1 and %d in",
+            num_in_q1, num_in_q2);
+    fprintf(outfile, " queue 2, servers %s and %s\n\n",
+            server1_status == BUSY ? "busy" : "idle",
+            server2_status == BUSY ? "busy" : "idle");
+
+    /* Measure each branch from the end of the warm-up, and fork the
+       branches. */
+
+    reset_stats();
+    fork_branches();
+
+    /* Invoke the report generator and end the simulation. */
+
+    report();
+
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    /* Initialize the simulation clock. */
+
+    sim_time = 0.0;
+
+    /* Initialize the state variables. */
+
+    server1_status  = IDLE;
+    server2_status  = IDLE;
+    num_in_q1       = 0;
+    num_in_q2       = 0;
+    time_last_event = 0.0;
+    overflow        = 0;
+
+    /* Initialize the statistical counters. */
+
+    reset_stats();
+
+    /* Initialize event list.  Since no customers are present, the departure
+       (service completion) event is eliminated from consideration, as is the
+       queue change operation. */
+
+    time_next_event[1] = sim_time + expon(mean_interarrival);
+    time_next_event[2] = 1.0e+30;
+    time_next_event[3] = 1.0e+30;
+}
+
+
+void run(float time_end)  /* Run the simulation until time_end. */
+{
+    /* Run the simulation until the next event falls after time_end.  That
+       event is left on the event list, so that the run can be continued from
+       time_end. */
+
+    for (;;) {
+
+        /* Determine the next event. */
+
+        timing();
+        if (sim_time > time_end)
+            break;
+
+        /* Update time-average statistical accumulators. */
+
+        update_time_avg_stats();
+
+        /* Invoke the appropriate event function. */
+
+        switch (next_event_type) {
+            case 1:
+                arrive();
+                break;
+            case 2:
+                change();
+                break;
+            case 3:
+                depart();
+                break;
+        }
+        if (overflow)
+            return;
+    }
+
+    /* Bring the time-average statistics up to time_end. */
+
+    sim_time = time_end;
+    update_time_avg_stats();
+}
+
+
+void reset_stats(void)  /* Reset the statistical counters. */
+{
+    num_custs_delayed1  = 0;
+    num_custs_delayed2  = 0;
+    total_of_delays1    = 0.0;
+    total_of_delays2    = 0.0;
+    area_num_in_q1      = 0.0;
+    area_num_in_q2      = 0.0;
+    area_server_status1 = 0.0;
+    area_server_status2 = 0.0;
+}
+
+
+void fork_branches(void)  /* Branch function.  Forks a process per branch from
+                             the warmed-up state, at most max_children at a
+                             time, and collects their outcomes. */
+{
+    int   b, num_running, pipe_fds[2], fds[BRANCH_LIMIT + 1];
+    pid_t pid, children[BRANCH_LIMIT + 1];
+
+    fflush(outfile);
+    num_running = 0;
+    for (b = 1; b <= num_branches; ++b) {
+
+        /* Wait for a running branch to finish, if as many as allowed are
+           running. */
+
+        if (num_running == max_children) {
+            collect(wait(NULL), children, fds);
+            --num_running;
+        }
+
+        /* The child process starts with a copy-on-write image of the state at
+           the end of the warm-up, and writes its outcome to its pipe. */
+
+        if (pipe(pipe_fds) != 0 || (pid = fork()) < 0) {
+            fprintf(stderr, "Cannot start branch %d\n", b);
+            exit(3);
+        }
+        if (pid == 0) {
+            close(pipe_fds[0]);
+            continue_branch(b, pipe_fds[1]);
+            _exit(0);
+        }
+        close(pipe_fds[1]);
+        children[b] = pid;
+        fds[b]      = pipe_fds[0];
+        ++num_running;
+    }
+
+    /* Wait for the remaining branches. */
+
+    while (num_running > 0) {
+        collect(wait(NULL), children, fds);
+        --num_running;
+    }
+}
+
+
+void continue_branch(int b, int fd)  /* Continuation function, run in the
+                                        child process of branch b. */
+{
+    struct outcome o;
+
+    /* Switch to the parameters and stream of the branch.  Events already on
+       the event list keep the times drawn for them in the warm-up. */
+
+    mean_interarrival = branches[b].mean_interarrival;
+    service_time1     = branches[b].service_time1;
+    service_time2     = branches[b].service_time2;
+    if (branches[b].stream > 0)
+        stream = branches[b].stream;
+
+    run(time_limit);
+
+    /* Compute the measures of performance over the continuation. */
+
+    o.overflow           = overflow;
+    o.num_custs_delayed1 = num_custs_delayed1;
+    o.num_custs_delayed2 = num_custs_delayed2;
+    o.avg_delay1    = total_of_delays1 / num_custs_delayed1;
+    o.avg_delay2    = total_of_delays2 / num_custs_delayed2;
+    o.avg_num_in_q1 = area_num_in_q1 / (sim_time - time_warmup);
+    o.avg_num_in_q2 = area_num_in_q2 / (sim_time - time_warmup);
+    o.utilization1  = area_server_status1 / (sim_time - time_warmup);
+    o.utilization2  = area_server_status2 / (sim_time - time_warmup);
+    if (write(fd, &o, sizeof(o)) != sizeof(o))
+        _exit(1);
+    close(fd);
+}
+
+
+void collect(pid_t pid, pid_t children[], int fds[])  /* Read the outcome of
+                                                         the branch whose
+                                                         process has ended. */
+{
+    int b;
+
+    for (b = 1; b <= num_branches; ++b)
+        if (children[b] == pid)
+            break;
+    if (b > num_branches)
+        return;
+
+    /* The outcome is shorter than a pipe buffer, so it was written in full
+       before the process ended. */
+
+    if (read(fds[b], &outcomes[b], sizeof(struct outcome)) !=
+        sizeof(struct outcome))
+        outcomes[b].overflow = -1;
+    close(fds[b]);
+    children[b] = 0;
+}
+
+
+void timing(void)  /* Timing function. */
+{
+    int   i;
+    float min_time_next_event = 1.0e+29;
+
+    next_event_type = 0;
+
+    /* Determine the event type of the next event to occur.  The arrival event
+       is always scheduled, so the event list is never empty. */
+
+    for (i = 1; i <= num_events; ++i)
+        if (time_next_event[i] < min_time_next_event) {
+            min_time_next_event = time_next_event[i];
+            next_event_type     = i;
+        }
+
+    /* Advance the simulation clock. */
+
+    sim_time = min_time_next_event;
+}
+
+
+void arrive(void)  /* Arrival event function. */
+{
+    /* Schedule next arrival. */
+
+    time_next_event[1] = sim_time + expon(mean_interarrival);
+
+    /* Check to see whether server 1 is busy. */
+
+    if (server1_status == BUSY) {
+
+        /* Server 1 is busy, so store the time of arrival of the arriving
+           customer at the end of the first queue, if there is room. */
+
+        if (++num_in_q1 > Q_LIMIT) {
+            overflow = 1;
+            return;
+        }
+        queue1[num_in_q1] = sim_time;
+    }
+
+    else {
+
+        /* Server 1 is idle, so the arriving customer has a delay of zero.
+           Increment the number of customers delayed, make server 1 busy and
+           schedule a queue change event. */
+
+        ++num_custs_delayed1;
+        server1_status     = BUSY;
+        time_next_event[2] = sim_time + expon(service_time1);
+    }
+}
+
+
+void change(void)  /* Queue change event function. */
+{
+    int i;
+
+    /* Check to see whether the first queue is empty. */
+
+    if (num_in_q1 == 0) {
+
+        /* The queue is empty so make server 1 idle and eliminate the queue
+           change event from consideration. */
+
+        server1_status     = IDLE;
+        time_next_event[2] = 1.0e+30;
+    }
+
+    else {
+
+        /* The queue is nonempty, so start the service of its first customer,
+           update the total delay accumulator, and move each customer in queue
+           (if any) up one place. */
+
+        --num_in_q1;
+        total_of_delays1  += sim_time - queue1[1];
+        ++num_custs_delayed1;
+        time_next_event[2] = sim_time + expon(service_time1);
+        for (i = 1; i <= num_in_q1; ++i)
+            queue1[i] = queue1[i + 1];
+    }
+
+    /* Check to see whether server 2 is busy. */
+
+    if (server2_status == BUSY) {
+
+        /* Server 2 is busy, so store the time of arrival of the customer at
+           the end of the second queue, if there is room. */
+
+        if (++num_in_q2 > Q_LIMIT) {
+            overflow = 2;
+            return;
+        }
+        queue2[num_in_q2] = sim_time;
+    }
+
+    else {
+
+        /* Server 2 is idle, so the customer has a delay of zero.  Increment
+           the number of customers delayed, make server 2 busy and schedule a
+           departure event. */
+
+        ++num_custs_delayed2;
+        server2_status     = BUSY;
+        time_next_event[3] = sim_time + expon(service_time2);
+    }
+}
+
+
+void depart(void)  /* Departure event function. */
+{
+    int i;
+
+    /* Check to see whether the second queue is empty. */
+
+    if (num_in_q2 == 0) {
+
+        /* The queue is empty so make server 2 idle and eliminate the departure
+           event from consideration. */
+
+        server2_status     = IDLE;
+        time_next_event[3] = 1.0e+30;
+    }
+
+    else {
+
+        /* The queue is nonempty, so start the service of its first customer,
+           update the total delay accumulator, and move each customer in queue
+           (if any) up one place. */
+
+        --num_in_q2;
+        total_of_delays2  += sim_time - queue2[1];
+        ++num_custs_delayed2;
+        time_next_event[3] = sim_time + expon(service_time2);
+        for (i = 1; i <= num_in_q2; ++i)
+            queue2[i] = queue2[i + 1];
+    }
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    int             b;
+    struct branch  *p;
+    struct outcome *o;
+
+    /* Write the measures of performance of each branch over its continuation
+       from the warm-up time to the time limit. */
+
+    fprintf(outfile, "                                     Average delay");
+    fprintf(outfile, "   Average number    Utilization\n");
+    fprintf(outfile, "Branch   Mean  Service time Stream  queue 1 queue 2");
+    fprintf(outfile, "  queue 1 queue 2        1     2\n");
+    fprintf(outfile, "        inter-     1     2\n");
+    fprintf(outfile, "       arrival\n");
+    for (b = 1; b <= num_branches; ++b) {
+        p = &branches[b];
+        o = &outcomes[b];
+        fprintf(outfile, "\n%6d%8.3f%7.3f%6.3f%7d", b, p->mean_interarrival,
+                p->service_time1, p->service_time2, p->stream);
+        if (o->overflow > 0)
+            fprintf(outfile, "  Overflow of queue %d", o->overflow);
+        else if (o->overflow < 0)
+            fprintf(outfile, "  Branch process failed");
+        else
+            fprintf(outfile, "%9.3f%8.3f%9.3f%8.3f%9.3f%6.3f",
+                    o->avg_delay1, o->avg_delay2, o->avg_num_in_q1,
+                    o->avg_num_in_q2, o->utilization1, o->utilization2);
+    }
+    fprintf(outfile, "\n");
+}
+
+
+void update_time_avg_stats(void)  /* Update area accumulators for time-average
+                                     statistics. */
+{
+    float time_since_last_event;
+
+    /* Compute time since last event, and update last-event-time marker. */
+
+    time_since_last_event = sim_time - time_last_event;
+    time_last_event       = sim_time;
+
+    /* Update areas under number-in-queue functions. */
+
+    area_num_in_q1      += num_in_q1 * time_since_last_event;
+    area_num_in_q2      += num_in_q2 * time_since_last_event;
+
+    /* Update areas under server-busy indicator functions. */
+
+    area_server_status1 += server1_status * time_since_last_event;
+    area_server_status2 += server2_status * time_since_last_event;
+}
+
+
+float expon(float mean)  /* Exponential variate generation function. */
+{
+    /* Return an exponential random variate with mean "mean" from the current
+       stream. */
+
+    return -mean * log(lcgrand(stream));
+}
@@ -0,0 +1,481 @@
+/* External definitions for parallel parameter sweep of the double-server
+   queueing system. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+#ifndef Q_LIMIT
+#define Q_LIMIT 5000  /* Limit on queue length. */
+#endif
+#define BUSY      1  /* Mnemonics for server's being busy */
+#define IDLE      0  /* and idle. */
+#define THREAD_LIMIT 256  /* Limit on number of worker threads. */
+#define NUM_MEASURES   6  /* Measures of performance reported per row. */
+
+struct row {  /* Parameters of one row of the sweep. */
+    float mean_interarrival, service_time1, service_time2;
+    int   time_limit, replications;
+};
+
+struct system {  /* State of one simulation of the system. */
+    int   next_event_type, num_custs_delayed1, num_custs_delayed2, num_in_q1,
+          num_in_q2, server1_status, server2_status;
+    float area_num_in_q1, area_num_in_q2, area_server_status1,
+          area_server_status2, sim_time, queue1[Q_LIMIT + 1],
+          queue2[Q_LIMIT + 1], time_last_event, time_next_event[4],
+          total_of_delays1, total_of_delays2;
+    long  z;
+    const struct row *row;
+};
+
+int   next_row, num_events, num_rows, num_rows_done, num_threads;
+long  zset;
+struct row *rows;
+pthread_mutex_t output_lock = PTHREAD_MUTEX_INITIALIZER;
+FILE  *infile, *outfile;
+
+int   read_rows(void);
+void *worker(void *arg);
+void  sweep_row(int k, struct system *sys);
+int   simulate(struct system *sys);
+void  initialize(struct system *sys);
+void  timing(struct system *sys);
+int   arrive(struct system *sys);
+int   change(struct system *sys);
+void  depart(struct system *sys);
+void  update_time_avg_stats(struct system *sys);
+float expon(float mean, long *zp);
+
+
+int main()  /* Main function. */
+{
+    int       i, num_started;
+    pthread_t threads[THREAD_LIMIT];
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm2sweep.in",  "r");
+    outfile = fopen("mm2sweep.out", "w");
+
+    /* Specify the number of events for the timing function. */
+
+    num_events = 3;
+
+    /* Read input parameters: the number of worker threads (0 means one per
+       online processor), and then one row "mean_interarrival service_time1
+       service_time2 time_limit replications" per parameter set. */
+
+    fscanf(infile, "%d", &num_threads);
+    if (num_threads <= 0)
+        num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_threads > THREAD_LIMIT)
+        num_threads = THREAD_LIMIT;
+    if (read_rows() == 0) {
+        fprintf(outfile, "\nNo parameter sets to simulate");
+        exit(1);
+    }
+    if (num_threads > num_rows)
+        num_threads = num_rows;
+
+    /* Write report heading.  The rows are reported as they complete, which
+       need not be in input order, and each line gives the means over the
+       replications of the row. */
+
+    fprintf(outfile, "Double-server queueing system, parameter sweep\n\n");
+    fprintf(outfile, "Number of parameter sets%14d\n\n", num_rows);
+    fprintf(outfile, "Number of threads%21d\n\n", num_threads);
+    fprintf(outfile, "        Mean Service time   Time        Average delay");
+    fprintf(outfile, "   Average number    Utilization\n");
+    fprintf(outfile, " Row  inter-      1     2  limit Reps  queue 1 queue 2");
+    fprintf(outfile, "  queue 1 queue 2        1     2\n");
+    fprintf(outfile, "     arrival\n");
+    fflush(outfile);
+
+    /* Every row starts from the same seed, as each run of mm2.c does, so that
+       a row reproduces mm2.c with the same parameters and all rows see
+       common random numbers. */
+
+    zset = lcgrandgt(1);
+
+    /* Run the rows on the pool of worker threads.  The workers claim rows
+       until none remain, so if not all the threads can be started, those
+       that were do all the rows. */
+
+    next_row = 0;
+    for (num_started = 0; num_started < num_threads; ++num_started)
+        if (pthread_create(&threads[num_started], NULL, worker, NULL) != 0)
+            break;
+    if (num_started == 0) {
+        fprintf(outfile, "\nCannot start a worker thread");
+        exit(3);
+    }
+    if (num_started < num_threads)
+        fprintf(stderr, "Started only %d of %d worker threads\n", num_started,
+                num_threads);
+    for (i = 0; i < num_started; ++i)
+        pthread_join(threads[i], NULL);
+
+    fprintf(outfile, "\n\nParameter sets completed%14d\n", num_rows_done);
+
+    free(rows);
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+int read_rows(void)  /* Parameter set input function. */
+{
+    int        capacity = 64, n;
+    struct row r;
+
+    rows     = malloc(capacity * sizeof(struct row));
+    num_rows = 0;
+    while ((n = fscanf(infile, "%f %f %f %d %d", &r.mean_interarrival,
+                       &r.service_time1, &r.service_time2, &r.time_limit,
+                       &r.replications)) == 5) {
+        if (num_rows == capacity) {
+            capacity *= 2;
+            rows      = realloc(rows, capacity * sizeof(struct row));
+        }
+        rows[num_rows++] = r;
+    }
+
+    /* Anything but the end of the file stops the sweep, rather than
+       silently cutting it short. */
+
+    if (n != EOF) {
+        fprintf(outfile, "\nInvalid parameter set in row %d", num_rows + 1);
+        exit(1);
+    }
+    return num_rows;
+}
+
+
+void *worker(void *arg)  /* Worker thread function. */
+{
+    int            k;
+    struct system *sys;
+
+    (void) arg;
+
+    /* The system state holds the two queues, so it is allocated once per
+       thread rather than on the thread's stack. */
+
+    sys = malloc(sizeof(struct system));
+
+    /* Repeatedly claim the next row and simulate it, until no rows remain. */
+
+    while ((k = __sync_fetch_and_add(&next_row, 1)) < num_rows)
+        sweep_row(k, sys);
+
+    free(sys);
+    return NULL;
+}
+
+
+void sweep_row(int k, struct system *sys)  /* Simulation and report function
+                                              for one row. */
+{
+    int   i, j, status;
+    float sum[NUM_MEASURES], measure[NUM_MEASURES];
+
+    /* Run the replications of the row one after another on one stream, as
+       mm2.c does. */
+
+    sys->row = &rows[k];
+    sys->z   = zset;
+    for (j = 0; j < NUM_MEASURES; ++j)
+        sum[j] = 0.0;
+    status = 0;
+    for (i = 0; i < sys->row->replications; ++i) {
+        status = simulate(sys);
+        if (status != 0)
+            break;
+        measure[0] = sys->total_of_delays1 / sys->num_custs_delayed1;
+        measure[1] = sys->total_of_delays2 / sys->num_custs_delayed2;
+        measure[2] = sys->area_num_in_q1 / sys->sim_time;
+        measure[3] = sys->area_num_in_q2 / sys->sim_time;
+        measure[4] = sys->area_server_status1 / sys->sim_time;
+        measure[5] = sys->area_server_status2 / sys->sim_time;
+        for (j = 0; j < NUM_MEASURES; ++j)
+            sum[j] += measure[j];
+    }
+
+    /* Write the line of the row as soon as it is complete. */
+
+    pthread_mutex_lock(&output_lock);
+    fprintf(outfile, "\n%4d%8.3f%7.3f%6.3f%7d%5d", k + 1,
+            sys->row->mean_interarrival, sys->row->service_time1,
+            sys->row->service_time2, sys->row->time_limit,
+            sys->row->replications);
+    if (status != 0)
+        fprintf(outfile, "  Overflow of queue %d at time %.3f in"
+                " replication %d", status, sys->sim_time, i + 1);
+    else if (sys->row->replications > 0) {
+        fprintf(outfile, "%9.3f%8.3f%9.3f%8.3f%9.3f%6.3f",
+                sum[0] / i, sum[1] / i, sum[2] / i, sum[3] / i, sum[4] / i,
+                sum[5] / i);
+        ++num_rows_done;
+    }
+    fflush(outfile);
+    pthread_mutex_unlock(&output_lock);
+}
+
+
+int simulate(struct system *sys)  /* Simulation function for one replication.
+                                     Returns 0, or the number of the queue
+                                     that overflowed. */
+{
+    int overflow = 0;
+
+    /* Initialize the simulation. */
+
+    initialize(sys);
+
+    /* Run the simulation while more time is needed. */
+
+    while (sys->sim_time < sys->row->time_limit && overflow == 0) {
+
+        /* Determine the next event. */
+
+        timing(sys);
+
+        /* Update time-average statistical accumulators. */
+
+        update_time_avg_stats(sys);
+
+        /* Invoke the appropriate event function. */
+
+        switch (sys->next_event_type) {
+            case 1:
+                overflow = arrive(sys);
+                break;
+            case 2:
+                overflow = change(sys);
+                break;
+            case 3:
+                depart(sys);
+                break;
+        }
+    }
+    return overflow;
+}
+
+
+void initialize(struct system *sys)  /* Initialization function. */
+{
+    /* Initialize the simulation clock. */
+
+    sys->sim_time = 0.0;
+
+    /* Initialize the state variables. */
+
+    sys->server1_status  = IDLE;
+    sys->server2_status  = IDLE;
+    sys->num_in_q1       = 0;
+    sys->num_in_q2       = 0;
+    sys->time_last_event = 0.0;
+
+    /* Initialize the statistical counters. */
+
+    sys->num_custs_delayed1  = 0;
+    sys->num_custs_delayed2  = 0;
+    sys->total_of_delays1    = 0.0;
+    sys->total_of_delays2    = 0.0;
+    sys->area_num_in_q1      = 0.0;
+    sys->area_num_in_q2      = 0.0;
+    sys->area_server_status1 = 0.0;
+    sys->area_server_status2 = 0.0;
+
+    /* Initialize event list.  Since no customers are present, the departure
+       (service completion) event is eliminated from consideration, as is the
+       queue change operation. */
+
+    sys->time_next_event[1] = sys->sim_time +
+                              expon(sys->row->mean_interarrival, &sys->z);
+    sys->time_next_event[2] = 1.0e+30;
+    sys->time_next_event[3] = 1.0e+30;
+}
+
+
+void timing(struct system *sys)  /* Timing function. */
+{
+    int   i;
+    float min_time_next_event = 1.0e+29;
+
+    sys->next_event_type = 0;
+
+    /* Determine the event type of the next event to occur.  The arrival event
+       is always scheduled, so the event list is never empty. */
+
+    for (i = 1; i <= num_events; ++i)
+        if (sys->time_next_event[i] < min_time_next_event) {
+            min_time_next_event  = sys->time_next_event[i];
+            sys->next_event_type = i;
+        }
+
+    /* Advance the simulation clock. */
+
+    sys->sim_time = min_time_next_event;
+}
+
+
+int arrive(struct system *sys)  /* Arrival event function.  Returns 1 if queue
+                                   1 overflows, and 0 otherwise. */
+{
+    /* Schedule next arrival. */
+
+    sys->time_next_event[1] = sys->sim_time +
+                              expon(sys->row->mean_interarrival, &sys->z);
+
+    /* Check to see whether server 1 is busy. */
+
+    if (sys->server1_status == BUSY) {
+
+        /* Server 1 is busy, so store the time of arrival of the arriving
+           customer at the end of the first queue, if there is room. */
+
+        if (++sys->num_in_q1 > Q_LIMIT)
+            return 1;
+        sys->queue1[sys->num_in_q1] = sys->sim_time;
+    }
+
+    else {
+
+        /* Server 1 is idle, so the arriving customer has a delay of zero.
+           Increment the number of customers delayed, make server 1 busy and
+           schedule a queue change event. */
+
+        ++sys->num_custs_delayed1;
+        sys->server1_status     = BUSY;
+        sys->time_next_event[2] = sys->sim_time +
+                                  expon(sys->row->service_time1, &sys->z);
+    }
+    return 0;
+}
+
+
+int change(struct system *sys)  /* Queue change event function.  Returns 2 if
+                                   queue 2 overflows, and 0 otherwise. */
+{
+    int i;
+
+    /* Check to see whether the first queue is empty. */
+
+    if (sys->num_in_q1 == 0) {
+
+        /* The queue is empty so make server 1 idle and eliminate the queue
+           change event from consideration. */
+
+        sys->server1_status     = IDLE;
+        sys->time_next_event[2] = 1.0e+30;
+    }
+
+    else {
+
+        /* The queue is nonempty, so start the service of its first customer,
+           update the total delay accumulator, and move each customer in queue
+           (if any) up one place. */
+
+        --sys->num_in_q1;
+        sys->total_of_delays1  += sys->sim_time - sys->queue1[1];
+        ++sys->num_custs_delayed1;
+        sys->time_next_event[2] = sys->sim_time +
+                                  expon(sys->row->service_time1, &sys->z);
+        for (i = 1; i <= sys->num_in_q1; ++i)
+            sys->queue1[i] = sys->queue1[i + 1];
+    }
+
+    /* Check to see whether server 2 is busy. */
+
+    if (sys->server2_status == BUSY) {
+
+        /* Server 2 is busy, so store the time of arrival of the customer at
+           the end of the second queue, if there is room. */
+
+        if (++sys->num_in_q2 > Q_LIMIT)
+            return 2;
+        sys->queue2[sys->num_in_q2] = sys->sim_time;
+    }
+
+    else {
+
+        /* Server 2 is idle, so the customer has a delay of zero.  Increment
+           the number of customers delayed, make server 2 busy and schedule a
+           departure event. */
+
+        ++sys->num_custs_delayed2;
+        sys->server2_status     = BUSY;
+        sys->time_next_event[3] = sys->sim_time +
+                                  expon(sys->row->service_time2, &sys->z);
+    }
+    return 0;
+}
+
+
+void depart(struct system *sys)  /* Departure event function. */
+{
+    int i;
+
+    /* Check to see whether the second queue is empty. */
+
+    if (sys->num_in_q2 == 0) {
+
+        /* The queue is empty so make server 2 idle and eliminate the departure
+           event from consideration. */
+
+        sys->server2_status     = IDLE;
+        sys->time_next_event[3] = 1.0e+30;
+    }
+
+    else {
+
+        /* The queue is nonempty, so start the service of its first customer,
+           update the total delay accumulator, and move each customer in queue
+           (if any) up one place. */
+
+        --sys->num_in_q2;
+        sys->total_of_delays2  += sys->sim_time - sys->queue2[1];
+        ++sys->num_custs_delayed2;
+        sys->time_next_event[3] = sys->sim_time +
+                                  expon(sys->row->service_time2, &sys->z);
+        for (i = 1; i <= sys->num_in_q2; ++i)
+            sys->queue2[i] = sys->queue2[i + 1];
+    }
+}
+
+
+void update_time_avg_stats(struct system *sys)  /* Update area accumulators for
+                                                   time-average statistics. */
+{
+    float time_since_last_event;
+
+    /* Compute time since last event, and update last-event-time marker. */
+
+    time_since_last_event = sys->sim_time - sys->time_last_event;
+    sys->time_last_event  = sys->sim_time;
+
+    /* Update areas under number-in-queue functions. */
+
+    sys->area_num_in_q1      += sys->num_in_q1 * time_since_last_event;
+    sys->area_num_in_q2      += sys->num_in_q2 * time_since_last_event;
+
+    /* Update areas under server-busy indicator functions. */
+
+    sys->area_server_status1 += sys->server1_status * time_since_last_event;
+    sys->area_server_status2 += sys->server2_status * time_since_last_event;
+}
+
+
+float expon(float mean, long *zp)  /* Exponential variate generation
+                                      function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrandz(zp));
+}
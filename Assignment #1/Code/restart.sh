@@ -0,0 +1,105 @@
+#!/bin/sh
+# Checkpoint and restart test of mm2, built with -DRESULTS.
+#
+# Usage: sh restart.sh
+#
+# mm2 is run once to completion, and once with checkpoints every 0.05 s,
+# killed with SIGKILL partway and restarted until it completes.  The report
+# and the three results files of the two runs must be identical.  Then a
+# checkpoint written by a -DREPLAY build, whose snapshot is laid out
+# differently, must be ignored by the same binary, which then runs afresh to
+# the same results.  The exit status is 0 if all of this holds, and 1
+# otherwise.
+
+CC=${CC:-gcc}
+HERE=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+$CC -O2 -DRESULTS -o "$WORK/sim" "$HERE/mm2.c" "$HERE/dist.c" \
+    "$HERE/lcgrand.c" -lm || exit 1
+$CC -O2 -DRESULTS -DREPLAY -o "$WORK/simreplay" "$HERE/mm2.c" \
+    "$HERE/dist.c" "$HERE/replay.c" "$HERE/lcgrand.c" -lm || exit 1
+$CC -O2 -o "$WORK/mkreplay" "$HERE/mkreplay.c" || exit 1
+mkdir "$WORK/whole" "$WORK/killed" "$WORK/replay" "$WORK/cross"
+echo "1 .7 .9 1000000" > "$WORK/whole/mm2.in1"
+echo "1 .7 .9 1000000 0.05" > "$WORK/killed/mm2.in1"
+
+(cd "$WORK/whole" && ../sim) || exit 1
+
+# Kill the run after a growing delay until one is interrupted after writing
+# a checkpoint, and then let the restarts finish it.
+
+cd "$WORK/killed" || exit 1
+interrupted=0
+for delay in 0.5 1 2 4; do
+    rm -f mm2.ckpt mm2.new.out
+    timeout -s KILL $delay ../sim 2>/dev/null
+    if [ $? -eq 137 ] && [ -f mm2.ckpt ]; then
+        interrupted=1
+        break
+    fi
+done
+if [ $interrupted -eq 0 ]; then
+    echo "restart.sh: could not interrupt the run after a checkpoint" >&2
+    exit 1
+fi
+kills=1
+while [ -f mm2.ckpt ]; do
+    timeout -s KILL 0.3 ../sim 2>/dev/null
+    status=$?
+    [ $status -eq 137 ] && kills=$((kills + 1))
+    if [ $status -ne 0 ] && [ $status -ne 137 ]; then
+        echo "restart.sh: restarted run failed with status $status" >&2
+        exit 1
+    fi
+done
+
+echo "Run killed $kills times"
+status=0
+for file in mm2.new.out mm2.csv mm2.jsonl mm2.col; do
+    if cmp -s "$WORK/whole/$file" "$WORK/killed/$file"; then
+        echo "$file: identical"
+    else
+        echo "$file: differs"
+        status=1
+    fi
+done
+
+# Replay a short trace with the same parameters, checkpointing as often as
+# possible, until the trace runs out (exit status 4) and leaves a snapshot.
+
+cd "$WORK/replay" || exit 1
+awk 'BEGIN { srand(1); t = 0;
+             for (i = 0; i < 200000; ++i) {
+                 t += -log(1 - rand());
+                 printf "%.6f %.6f %.6f\n", t, -0.7 * log(1 - rand()),
+                        -0.9 * log(1 - rand());
+             } }' > trace.txt
+../mkreplay trace.txt mm2.rep || exit 1
+echo "1 .7 .9 1000000 0.000001" > mm2.in1
+../simreplay
+if [ $? -ne 4 ] || [ ! -f mm2.ckpt ]; then
+    echo "restart.sh: replay run left no checkpoint" >&2
+    exit 1
+fi
+
+# The snapshot must be ignored, with a message, by the build without replay.
+
+cd "$WORK/cross" || exit 1
+cp "$WORK/replay/mm2.ckpt" "$WORK/killed/mm2.in1" .
+if ../sim 2>&1 | grep -q "Ignoring mm2.ckpt"; then
+    echo "Checkpoint of the replay build: ignored"
+else
+    echo "Checkpoint of the replay build: not ignored"
+    status=1
+fi
+for file in mm2.new.out mm2.csv mm2.jsonl mm2.col; do
+    if cmp -s "$WORK/whole/$file" "$WORK/cross/$file"; then
+        echo "$file after cross-build checkpoint: identical"
+    else
+        echo "$file after cross-build checkpoint: differs"
+        status=1
+    fi
+done
+exit $status
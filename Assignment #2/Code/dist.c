@@ -0,0 +1,392 @@
+/* Service-time distributions.  See dist.h for usage. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "dist.h"  /* Header file for this module. */
+
+static int    build_table(struct dist *d);
+static int    build_guide(struct dist *d);
+static double gamma_p(double a, double x);
+static double gamma_inverse(double a, double u);
+static double normal_inverse(double u);
+static uint64_t hash_bytes(uint64_t h, const void *p, size_t n);
+
+
+void dist_expon(struct dist *d, double mean)  /* Make an exponential
+                                                 distribution. */
+{
+    memset(d, 0, sizeof(*d));
+    d->kind         = DIST_EXPON;
+    d->mean         = mean;
+    d->num_uniforms = 1;
+}
+
+
+int dist_read(FILE *infile, struct dist *d, double mean)  /* Read a
+                                                             distribution. */
+{
+    char name[16];
+    int  i;
+
+    dist_expon(d, mean);
+    if (fscanf(infile, "%15s", name) != 1)
+        return -1;
+
+    if (strcmp(name, "expon") == 0)
+        return mean > 0.0 ? 0 : -1;
+
+    if (strcmp(name, "erlang") == 0) {
+
+        /* The sum of k exponentials, each with mean mean / k. */
+
+        d->kind = DIST_ERLANG;
+        if (fscanf(infile, "%d", &d->k) != 1 || d->k < 1 || mean <= 0.0)
+            return -1;
+        d->scale        = mean / d->k;
+        d->num_uniforms = d->k;
+        return 0;
+    }
+
+    if (strcmp(name, "deterministic") == 0) {
+        d->kind         = DIST_DETERMINISTIC;
+        d->num_uniforms = 0;
+        return mean >= 0.0 ? 0 : -1;
+    }
+
+    if (strcmp(name, "gamma") == 0) {
+        d->kind = DIST_GAMMA;
+        if (fscanf(infile, "%lf", &d->shape) != 1 || d->shape <= 0.0 ||
+            mean <= 0.0)
+            return -1;
+        d->scale = mean / d->shape;
+        return build_table(d);
+    }
+
+    if (strcmp(name, "lognormal") == 0) {
+
+        /* The shape parameter is the coefficient of variation, from which
+           the mean and standard deviation of the underlying normal follow. */
+
+        d->kind = DIST_LOGNORMAL;
+        if (fscanf(infile, "%lf", &d->shape) != 1 || d->shape <= 0.0 ||
+            mean <= 0.0)
+            return -1;
+        d->sigma = sqrt(log(1.0 + d->shape * d->shape));
+        d->mu    = log(mean) - 0.5 * d->sigma * d->sigma;
+        return build_table(d);
+    }
+
+    if (strcmp(name, "weibull") == 0) {
+        d->kind = DIST_WEIBULL;
+        if (fscanf(infile, "%lf", &d->shape) != 1 || d->shape <= 0.0 ||
+            mean <= 0.0)
+            return -1;
+        d->scale = mean / tgamma(1.0 + 1.0 / d->shape);
+        return build_table(d);
+    }
+
+    if (strcmp(name, "empirical") == 0) {
+
+        /* Read the points of the distribution function, which must start at
+           probability 0, end at probability 1, and never decrease. */
+
+        d->kind = DIST_EMPIRICAL;
+        if (fscanf(infile, "%d", &d->num_points) != 1 || d->num_points < 2)
+            return -1;
+        d->x   = malloc(d->num_points * sizeof(double));
+        d->cdf = malloc(d->num_points * sizeof(double));
+        if (d->x == NULL || d->cdf == NULL)
+            return -1;
+        for (i = 0; i < d->num_points; ++i)
+            if (fscanf(infile, "%lf %lf", &d->x[i], &d->cdf[i]) != 2 ||
+                (i > 0 && (d->x[i] < d->x[i - 1] ||
+                           d->cdf[i] < d->cdf[i - 1])))
+                return -1;
+        if (d->cdf[0] != 0.0 || d->cdf[d->num_points - 1] != 1.0)
+            return -1;
+
+        /* The mean is the sum over the intervals of their probability times
+           their midpoint. */
+
+        d->mean = 0.0;
+        for (i = 0; i < d->num_points - 1; ++i)
+            d->mean += (d->cdf[i + 1] - d->cdf[i]) *
+                       0.5 * (d->x[i] + d->x[i + 1]);
+        return build_guide(d);
+    }
+
+    return -1;
+}
+
+
+double dist_inverse(struct dist *d, double u)  /* Return the inverse of the
+                                                  distribution function at u,
+                                                  computed exactly. */
+{
+    if (u <= 0.0)
+        return d->kind == DIST_EMPIRICAL ? d->x[0] : 0.0;
+    switch (d->kind) {
+        case DIST_EXPON:
+            return -d->mean * log1p(-u);
+        case DIST_GAMMA:
+            return d->scale * gamma_inverse(d->shape, u);
+        case DIST_LOGNORMAL:
+            return exp(d->mu + d->sigma * normal_inverse(u));
+        case DIST_WEIBULL:
+            return d->scale * pow(-log1p(-u), 1.0 / d->shape);
+        case DIST_DETERMINISTIC:
+            return d->mean;
+        case DIST_EMPIRICAL:
+            return u < 1.0 ? dist_lookup(d, u) : d->x[d->num_points - 1];
+        default:
+            return d->scale * gamma_inverse(d->k, u);
+    }
+}
+
+
+void dist_describe(struct dist *d, char *buf, int n)  /* Describe a
+                                                         distribution. */
+{
+    switch (d->kind) {
+        case DIST_EXPON:
+            snprintf(buf, n, "exponential");
+            break;
+        case DIST_ERLANG:
+            snprintf(buf, n, "Erlang, k = %d", d->k);
+            break;
+        case DIST_GAMMA:
+            snprintf(buf, n, "gamma, shape %.3f", d->shape);
+            break;
+        case DIST_LOGNORMAL:
+            snprintf(buf, n, "lognormal, cv %.3f", d->shape);
+            break;
+        case DIST_WEIBULL:
+            snprintf(buf, n, "Weibull, shape %.3f", d->shape);
+            break;
+        case DIST_DETERMINISTIC:
+            snprintf(buf, n, "deterministic");
+            break;
+        case DIST_EMPIRICAL:
+            snprintf(buf, n, "empirical, %d points, mean %.3f", d->num_points,
+                     d->mean);
+            break;
+    }
+}
+
+
+uint64_t dist_checksum(struct dist *d)  /* Return a hash of a
+                                          distribution. */
+{
+    uint64_t h;
+
+    /* The tables of a parametric distribution follow from its kind and
+       parameters; those of an empirical one are hashed point by point. */
+
+    h = 14695981039346656037ULL;  /* FNV-1a offset basis. */
+    h = hash_bytes(h, &d->kind, sizeof(d->kind));
+    h = hash_bytes(h, &d->k, sizeof(d->k));
+    h = hash_bytes(h, &d->shape, sizeof(d->shape));
+    h = hash_bytes(h, &d->mean, sizeof(d->mean));
+    if (d->kind == DIST_EMPIRICAL) {
+        h = hash_bytes(h, &d->num_points, sizeof(d->num_points));
+        h = hash_bytes(h, d->x, d->num_points * sizeof(double));
+        h = hash_bytes(h, d->cdf, d->num_points * sizeof(double));
+    }
+    return h;
+}
+
+
+void dist_free(struct dist *d)  /* Free the tables of a distribution. */
+{
+    free(d->x);
+    free(d->cdf);
+    free(d->guide);
+    d->x     = NULL;
+    d->cdf   = NULL;
+    d->guide = NULL;
+}
+
+
+static int build_table(struct dist *d)  /* Tabulate the quantiles of a
+                                           parametric distribution. */
+{
+    int i;
+
+    /* Point i is the quantile at probability i / DIST_TABLE_SIZE.  The last
+       point is one cell short of probability 1, since the quantile there is
+       infinite. */
+
+    d->num_points = DIST_TABLE_SIZE;
+    d->x          = malloc(d->num_points * sizeof(double));
+    d->cdf        = malloc(d->num_points * sizeof(double));
+    if (d->x == NULL || d->cdf == NULL)
+        return -1;
+    for (i = 0; i < d->num_points; ++i) {
+        d->cdf[i] = (double) i / DIST_TABLE_SIZE;
+        d->x[i]   = dist_inverse(d, d->cdf[i]);
+    }
+    return build_guide(d);
+}
+
+
+static int build_guide(struct dist *d)  /* Build the guide table. */
+{
+    int i, j;
+
+    /* Entry j is the last point at or below probability j / num_guide, so
+       that a lookup starts in, or just before, the interval it needs. */
+
+    d->num_guide = d->num_points;
+    d->guide     = malloc(d->num_guide * sizeof(int));
+    if (d->guide == NULL)
+        return -1;
+    i = 0;
+    for (j = 0; j < d->num_guide; ++j) {
+        while (i < d->num_points - 2 &&
+               d->cdf[i + 1] <= (double) j / d->num_guide)
+            ++i;
+        d->guide[j] = i;
+    }
+    return 0;
+}
+
+
+static double gamma_p(double a, double x)  /* Return the regularized lower
+                                              incomplete gamma function. */
+{
+    int    i;
+    double sum, term, b, c, dd, h, an, delta;
+
+    if (x <= 0.0)
+        return 0.0;
+    if (x < a + 1.0) {
+
+        /* Sum the series, which converges quickly below a + 1. */
+
+        term = sum = 1.0 / a;
+        for (i = 1; i < 1000 && fabs(term) > 1.0e-16 * fabs(sum); ++i) {
+            term *= x / (a + i);
+            sum  += term;
+        }
+        return sum * exp(-x + a * log(x) - lgamma(a));
+    }
+
+    /* Evaluate the continued fraction for the upper function by Lentz's
+       method. */
+
+    b  = x + 1.0 - a;
+    c  = 1.0e+300;
+    dd = 1.0 / b;
+    h  = dd;
+    for (i = 1; i < 1000; ++i) {
+        an = -i * (i - a);
+        b += 2.0;
+        dd = an * dd + b;
+        if (fabs(dd) < 1.0e-300)
+            dd = 1.0e-300;
+        c = b + an / c;
+        if (fabs(c) < 1.0e-300)
+            c = 1.0e-300;
+        dd    = 1.0 / dd;
+        delta = dd * c;
+        h    *= delta;
+        if (fabs(delta - 1.0) < 1.0e-16)
+            break;
+    }
+    return 1.0 - exp(-x + a * log(x) - lgamma(a)) * h;
+}
+
+
+static double gamma_inverse(double a, double u)  /* Return the quantile at u
+                                                    of the gamma distribution
+                                                    with shape a and scale
+                                                    1. */
+{
+    int    i;
+    double lo, hi, x, f, density;
+
+    /* Bracket the quantile, and then refine it by Newton steps, falling back
+       on bisection when a step would leave the bracket. */
+
+    lo = 0.0;
+    hi = a > 1.0 ? a : 1.0;
+    while (gamma_p(a, hi) < u) {
+        lo  = hi;
+        hi *= 2.0;
+    }
+    x = 0.5 * (lo + hi);
+    for (i = 0; i < 200 && hi - lo > 1.0e-15 * hi; ++i) {
+        f = gamma_p(a, x) - u;
+        if (f == 0.0)
+            break;
+        if (f < 0.0)
+            lo = x;
+        else
+            hi = x;
+        density = exp((a - 1.0) * log(x) - x - lgamma(a));
+        x      -= f / density;
+        if (!(x > lo && x < hi))
+            x = 0.5 * (lo + hi);
+    }
+    return x;
+}
+
+
+static double normal_inverse(double u)  /* Return the quantile at u of the
+                                           standard normal distribution. */
+{
+    static const double a[6] = {-3.969683028665376e+01, 2.209460984245205e+02,
+                                -2.759285104469687e+02, 1.383577518672690e+02,
+                                -3.066479806614716e+01, 2.506628277459239e+00},
+                        b[5] = {-5.447609879822406e+01, 1.615858368580409e+02,
+                                -1.556989798598866e+02, 6.680131188771972e+01,
+                                -1.328068155288572e+01},
+                        c[6] = {-7.784894002430293e-03, -3.223964580411365e-01,
+                                -2.400758277161838e+00, -2.549732539343734e+00,
+                                4.374664141464968e+00, 2.938163982698783e+00},
+                        d[4] = {7.784695709041462e-03, 3.224671290700398e-01,
+                                2.445134137142996e+00, 3.754408661907416e+00};
+    double q, r, z, e;
+
+    /* Acklam's rational approximation, with relative error below 1.2e-9 ... */
+
+    if (u < 0.02425) {
+        q = sqrt(-2.0 * log(u));
+        z = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q +
+             c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    else if (u <= 1.0 - 0.02425) {
+        q = u - 0.5;
+        r = q * q;
+        z = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r +
+             a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r +
+             b[4]) * r + 1.0);
+    }
+    else {
+        q = sqrt(-2.0 * log1p(-u));
+        z = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q +
+              c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+
+    /* ... refined by one step of Halley's method to full precision. */
+
+    e  = 0.5 * erfc(-z / sqrt(2.0)) - u;
+    r  = e * sqrt(2.0 * M_PI) * exp(0.5 * z * z);
+    return z - r / (1.0 + 0.5 * z * r);
+}
+
+
+static uint64_t hash_bytes(uint64_t h, const void *p, size_t n)  /* Fold n
+                                                 bytes into an FNV-1a hash. */
+{
+    const unsigned char *b = p;
+    size_t               i;
+
+    for (i = 0; i < n; ++i) {
+        h ^= b[i];
+        h *= 1099511628211ULL;  /* FNV-1a prime. */
+    }
+    return h;
+}
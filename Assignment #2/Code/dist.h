@@ -0,0 +1,117 @@
+/* Service-time distributions selectable from the input file: exponential,
+   Erlang, gamma, lognormal, Weibull, deterministic, and empirical (a
+   piecewise-linear distribution function through measured points).  The
+   parametric distributions are given by their mean and one shape parameter.
+   Gamma, lognormal, and Weibull variates, whose inverse distribution functions
+   are expensive or have no closed form, are generated by inversion from a
+   table of DIST_TABLE_SIZE quantiles computed once, with linear interpolation
+   between them; the top cell of the table, which holds the unbounded tail, is
+   inverted exactly.  Empirical variates are generated by inversion of their
+   distribution function.  Both are looked up in constant expected time
+   through a guide table, which gives for each of num_guide equal intervals of
+   probability the first point at or below it.  This file (named dist.h)
+   should be included in any program using these functions by executing
+       #include "dist.h"
+   before referencing the functions.
+
+   Usage:
+       dist_expon(&d, mean)         makes d exponential with mean "mean",
+       dist_read(infile, &d, mean)  reads a distribution as "expon",
+                                    "erlang k", "gamma shape", "lognormal cv"
+                                    (cv the coefficient of variation),
+                                    "weibull shape", "deterministic", or
+                                    "empirical n x_1 F_1 ... x_n F_n" (with
+                                    F_1 = 0 and F_n = 1, ignoring "mean"), and
+                                    returns 0, or -1 if it is invalid,
+       dist_sample(&d, stream)      returns a variate, using random-number
+                                    stream "stream",
+       dist_describe(&d, buf, n)    writes a description of d to buf,
+       dist_checksum(&d)            returns a 64-bit FNV-1a hash of its
+                                    kind, parameters and empirical points,
+                                    which differs, with high probability, for
+                                    any two different distributions, and
+       dist_free(&d)                frees its tables. */
+
+#ifndef DIST_H
+#define DIST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+#define DIST_EXPON         0  /* Distribution kinds. */
+#define DIST_ERLANG        1
+#define DIST_GAMMA         2
+#define DIST_LOGNORMAL     3
+#define DIST_WEIBULL       4
+#define DIST_DETERMINISTIC 5
+#define DIST_EMPIRICAL     6
+#define DIST_TABLE_SIZE 4096  /* Quantiles tabulated for a parametric
+                                 distribution. */
+
+struct dist {
+    int     kind, k, num_points, num_guide, num_uniforms, *guide;
+    double  mean, shape, scale, mu, sigma, *x, *cdf;
+};
+
+void   dist_expon(struct dist *d, double mean);
+int    dist_read(FILE *infile, struct dist *d, double mean);
+double dist_inverse(struct dist *d, double u);
+void   dist_describe(struct dist *d, char *buf, int n);
+uint64_t dist_checksum(struct dist *d);
+void   dist_free(struct dist *d);
+
+static inline double dist_lookup(struct dist *d, double u)  /* Return the
+                                           tabulated inverse at u, given that
+                                           u is below the last point. */
+{
+    int i;
+
+    /* Start at the guide entry for u, and step to the interval holding it. */
+
+    i = d->guide[(int) (u * d->num_guide)];
+    while (d->cdf[i + 1] <= u)
+        ++i;
+    return d->x[i] + (d->x[i + 1] - d->x[i]) * (u - d->cdf[i]) /
+                     (d->cdf[i + 1] - d->cdf[i]);
+}
+
+static inline double dist_sample(struct dist *d, int stream)  /* Generate a
+                                                                 variate. */
+{
+    int    i;
+    double u, product, sum;
+
+    switch (d->kind) {
+        case DIST_EXPON:
+            return -d->mean * log(lcgrand(stream));
+        case DIST_ERLANG:
+
+            /* Take the logarithm of the product of the uniforms rather than
+               summing their logarithms, folding it into the sum before it
+               can underflow. */
+
+            product = 1.0;
+            sum     = 0.0;
+            for (i = 0; i < d->k; ++i) {
+                product *= lcgrand(stream);
+                if (product < 1.0e-200) {
+                    sum    += log(product);
+                    product = 1.0;
+                }
+            }
+            return -d->scale * (sum + log(product));
+        case DIST_DETERMINISTIC:
+            return d->mean;
+        case DIST_EMPIRICAL:
+            return dist_lookup(d, lcgrand(stream));
+        default:
+            u = lcgrand(stream);
+            if (u >= d->cdf[d->num_points - 1])
+                return dist_inverse(d, u);
+            return dist_lookup(d, u);
+    }
+}
+
+#endif
@@ -0,0 +1,119 @@
+/* Hot-path instrumentation for the simulation models.  When a model is
+   compiled with -DINSTRUMENT, the hooks below record, for the timing function,
+   the time-average statistics update and each event type, the number of calls,
+   the time spent (in TSC cycles on x86, otherwise in nanoseconds), the
+   random-number calls made, and the queue entries shifted.  The time spent in
+   the random-number generator is recorded separately (it is included in the
+   time of the section that called it).  INSTR_REPORT writes the figures
+   accumulated since the previous report to the output file and resets them.
+   Without -DINSTRUMENT the hooks expand to nothing.  This file (named instr.h)
+   should be included in the model by executing
+       #include "instr.h"
+   and the hooks used as
+       INSTR_BEGIN(slot);      before timing(), update_time_avg_stats() or the
+                               event switch, with slot INSTR_TIMING, INSTR_STATS
+                               or INSTR_EVENT(next_event_type),
+       INSTR_END(slot);        after it, with the same slot,
+       INSTR_RNG_BEGIN();      before a variate is generated,
+       INSTR_RNG_END(n);       after it, with n the number of lcgrand calls,
+       INSTR_SHIFT(n);         when n queue entries are moved up, and
+       INSTR_REPORT(outfile);  in report(). */
+
+#ifdef INSTRUMENT
+
+#include <stdio.h>
+
+#define INSTR_SLOTS    16  /* Timing, statistics, up to 13 event types, and
+                              work done outside these (e.g., initialize()). */
+#define INSTR_TIMING    0
+#define INSTR_STATS     1
+#define INSTR_EVENT(k) (1 + (k))
+#define INSTR_OTHER    (INSTR_SLOTS - 1)
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define INSTR_UNIT "cycles"
+static unsigned long long instr_clock(void)  /* Return the time-stamp
+                                                counter. */
+{
+    return __rdtsc();
+}
+#else
+#include <time.h>
+#define INSTR_UNIT "ns"
+static unsigned long long instr_clock(void)  /* Return a monotonic time in
+                                                nanoseconds. */
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#endif
+
+static int                instr_slot = INSTR_OTHER;
+static unsigned long long instr_start, instr_rng_start, instr_rng_time,
+                          instr_calls[INSTR_SLOTS], instr_time[INSTR_SLOTS],
+                          instr_rng_calls[INSTR_SLOTS],
+                          instr_shifts[INSTR_SLOTS];
+
+static void instr_report(FILE *outfile)  /* Write and reset the figures. */
+{
+    int                i;
+    unsigned long long total_rng;
+
+    fprintf(outfile, "\n\nInstrumentation (%s)\n\n", INSTR_UNIT);
+    fprintf(outfile, "  Section              Calls          Time   Per call");
+    fprintf(outfile, "   RNG calls   Per call      Shifts\n");
+    total_rng = 0;
+    for (i = 0; i < INSTR_SLOTS; ++i) {
+        if (instr_calls[i] == 0 && instr_rng_calls[i] == 0 &&
+            instr_shifts[i] == 0)
+            continue;
+        if (i == INSTR_OTHER)
+            fprintf(outfile, "\n  other          ");
+        else if (i == INSTR_TIMING)
+            fprintf(outfile, "\n  timing()       ");
+        else if (i == INSTR_STATS)
+            fprintf(outfile, "\n  statistics     ");
+        else
+            fprintf(outfile, "\n  event type %-4d", i - 1);
+        fprintf(outfile, "%11llu%14llu%11.1f%12llu%11.3f%12llu",
+                instr_calls[i], instr_time[i],
+                instr_calls[i] ? (double) instr_time[i] / instr_calls[i] :
+                                 0.0,
+                instr_rng_calls[i],
+                instr_calls[i] ? (double) instr_rng_calls[i] / instr_calls[i] :
+                                 0.0,
+                instr_shifts[i]);
+        total_rng += instr_rng_calls[i];
+    }
+    if (total_rng > 0)
+        fprintf(outfile, "\n  generator      %11llu%14llu%11.1f", total_rng,
+                instr_rng_time, (double) instr_rng_time / total_rng);
+    for (i = 0; i < INSTR_SLOTS; ++i)
+        instr_calls[i] = instr_time[i] = instr_rng_calls[i] =
+            instr_shifts[i] = 0;
+    instr_rng_time = 0;
+}
+
+#define INSTR_BEGIN(slot)   (instr_slot = (slot), instr_start = instr_clock())
+#define INSTR_END(slot)     (instr_time[slot] += instr_clock() - instr_start, \
+                             ++instr_calls[slot], instr_slot = INSTR_OTHER)
+#define INSTR_RNG_BEGIN()   (instr_rng_start = instr_clock())
+#define INSTR_RNG_END(n)    (instr_rng_time += instr_clock() - \
+                                               instr_rng_start, \
+                             instr_rng_calls[instr_slot] += (n))
+#define INSTR_SHIFT(n)      (instr_shifts[instr_slot] += (n))
+#define INSTR_REPORT(f)     instr_report(f)
+
+#else
+
+#define INSTR_BEGIN(slot)
+#define INSTR_END(slot)
+#define INSTR_RNG_BEGIN()
+#define INSTR_RNG_END(n)
+#define INSTR_SHIFT(n)
+#define INSTR_REPORT(f)
+
+#endif
@@ -3,18 +3,37 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include "lcgrand.h"  /* Header file for random-number generator. */
+#include "bench.h"    /* Header file for benchmark hooks. */
+#include "instr.h"    /* Header file for instrumentation hooks. */
+#include "results.h"  /* Header file for machine-readable results. */
+#include "trace.h"    /* Header file for event tracer. */
+#include "dist.h"     /* Header file for service-time distributions. */
 
+#ifndef Q_LIMIT
 #define Q_LIMIT 10000  /* Limit on queue length. */
+#endif
 #define BUSY      1  /* Mnemonics for server's being busy */
 #define IDLE      0  /* and idle. */
 
+struct time_avg {  /* Time-weighted accumulator for a state variable: the area
+                     under it up to its last change, and the time of that
+                     change. */
+    float area, time_last_change;
+};
+
 int   next_event_type, num_custs_delayed1, num_custs_delayed2, time_limit, num_events,
-      num_in_q1, num_in_q2, server1_status, server2_status, max_in_transit, num_in_transit, total_in_transit;
+      num_in_q1, num_in_q2, server1_status, server2_status, max_in_transit, num_in_transit;
       
-float area_num_in_q1, area_num_in_q2, area_server_status1, area_server_status2, mean_interarrival, service_time1, service_time2,
-      sim_time, queue1[Q_LIMIT + 1], queue2[Q_LIMIT + 1], time_last_event, time_next_event[6],
+float mean_interarrival, service_time1, service_time2,
+      sim_time, queue1[Q_LIMIT + 1], queue2[Q_LIMIT + 1], time_next_event[6],
       total_of_delays1, total_of_delays2;
+
+struct time_avg stat_q1, stat_q2, stat_server1, stat_server2, stat_transit;
+
+struct dist service_dist[3], transit_dist;
+int         transit_uniform;
       
 FILE  *infile, *outfile;
 
@@ -26,16 +45,26 @@ void  depart1(void);
 void  depart2(void);
 void  finish(void);
 void  report(void);
+void  time_avg_init(struct time_avg *s);
+void  time_avg_change(struct time_avg *s, int value);
 void  update_time_avg_stats(void);
 float expon(float mean);
 float uniform(float a, float b);
+float service(int station);
+float transit(void);
+void  describe(const char *what, struct dist *d);
 
 int main()  /* Main function. */
 {
+    char  keyword[16];
+    int   station;
+    float transit_mean;
+
     /* Open input and output files. */
 
     infile  = fopen("mm2_t.in",  "r");
     outfile = fopen("mm2_t.out", "w");
+    RESULTS_OPEN("mm2_t", 1);
 
     /* Specify the number of events for the timing function. */
 
@@ -44,7 +73,44 @@ int main()  /* Main function. */
     /* Read input parameters. */
 
     fscanf(infile, "%f %f %f %d", &mean_interarrival, &service_time1, &service_time2, &time_limit);
-           
+
+    /* Service times are exponential and transit times U(0,2) unless lines of
+       the form "service <server> <distribution>" or
+       "transit <mean> <distribution>" follow, with the distribution written as
+       described in dist.h.  Service distributions take their mean from the
+       first line.  Any other line is an error, rather than being silently
+       ignored. */
+
+    dist_expon(&service_dist[1], service_time1);
+    dist_expon(&service_dist[2], service_time2);
+    transit_uniform = 1;
+    while (fscanf(infile, " %15s", keyword) == 1) {
+        if (strcmp(keyword, "service") == 0) {
+            if (fscanf(infile, "%d", &station) != 1 || station < 1 ||
+                station > 2) {
+                fprintf(stderr, "Invalid server in service line\n");
+                exit(1);
+            }
+            if (dist_read(infile, &service_dist[station],
+                          station == 1 ? service_time1 : service_time2) != 0) {
+                fprintf(stderr, "Invalid service distribution for server %d\n",
+                        station);
+                exit(1);
+            }
+        }
+        else if (strcmp(keyword, "transit") == 0) {
+            transit_uniform = 0;
+            if (fscanf(infile, "%f", &transit_mean) != 1 ||
+                dist_read(infile, &transit_dist, transit_mean) != 0) {
+                fprintf(stderr, "Invalid transit-time distribution\n");
+                exit(1);
+            }
+        }
+        else {
+            fprintf(stderr, "Unknown input line \"%s\"\n", keyword);
+            exit(1);
+        }
+    }
 
     /* Write report heading and input parameters. */
 
@@ -54,24 +120,43 @@ int main()  /* Main function. */
     fprintf(outfile, "Mean service time for server 1%16.3f minutes\n\n", service_time1);
     fprintf(outfile, "Mean service time for server 2%16.3f minutes\n\n", service_time2);
     fprintf(outfile, "Time limit%14d\n\n", time_limit);
+    if (service_dist[1].kind != DIST_EXPON)
+        describe("Service distribution for server 1", &service_dist[1]);
+    if (service_dist[2].kind != DIST_EXPON)
+        describe("Service distribution for server 2", &service_dist[2]);
+    if (!transit_uniform)
+        describe("Transit-time distribution", &transit_dist);
 
     /* Initialize the simulation. */
 
+BENCH_START();
+TRACE_OPEN("mm2_t.trace");
 for(int i = 0; i < 10; i++) {    
+	TRACE_REPLICATION(i);
+	RESULTS_START(i);
 	initialize();
 
 		int running = 1;
 		while(running) {
 			/* Determine the next event. */
 
+			INSTR_BEGIN(INSTR_TIMING);
 			timing();
-
-			/* Update time-average statistical accumulators. */
-
-			update_time_avg_stats();
-
-			/* Invoke the appropriate event function. */
-
+			INSTR_END(INSTR_TIMING);
+			BENCH_EVENT();
+
+			/* Invoke the appropriate event function.  The time-average
+			   statistical accumulators are updated by the event functions,
+			   only for the variables that they change.  The end-simulation
+			   event is not timed, since report() writes the instrumentation
+			   figures and resets them for the next replication. */
+
+			if (next_event_type == 5) {
+				finish();
+				running = 0;
+				continue;
+			}
+			INSTR_BEGIN(INSTR_EVENT(next_event_type));
 			switch (next_event_type) {
 				case 1:
 					arrive1();
@@ -85,16 +170,19 @@ for(int i = 0; i < 10; i++) {
 				case 4:
 					depart2();
 					break;
-				case 5:
-					finish();
-					running = 0;
-					break;
 			}
+			INSTR_END(INSTR_EVENT(next_event_type));
 		}
 
     
 }
+BENCH_STOP();
+TRACE_CLOSE();
+RESULTS_CLOSE();
 
+    dist_free(&service_dist[1]);
+    dist_free(&service_dist[2]);
+    dist_free(&transit_dist);
     fclose(infile);
     fclose(outfile);
 
@@ -113,8 +201,7 @@ void initialize(void)  /* Initialization function. */
     server2_status  = IDLE;
     num_in_q1       = 0;
     num_in_q2       = 0;
-    
-    time_last_event = 0.0;
+    num_in_transit  = 0;
 
     /* Initialize the statistical counters. */
 
@@ -122,13 +209,12 @@ void initialize(void)  /* Initialization function. */
     num_custs_delayed2  = 0;
     total_of_delays1    = 0.0;
     total_of_delays2    = 0.0;
-    area_num_in_q1      = 0.0;
-    area_num_in_q2      = 0.0;
-    area_server_status1 = 0.0;
-    area_server_status2 = 0.0;
-    num_in_transit = 0;
-    max_in_transit = 0;
-    total_in_transit = 0;
+    max_in_transit      = 0;
+    time_avg_init(&stat_q1);
+    time_avg_init(&stat_q2);
+    time_avg_init(&stat_server1);
+    time_avg_init(&stat_server2);
+    time_avg_init(&stat_transit);
 
     /* Initialize event list.  Since no customers are present, the departure
        (service completion) event is eliminated from consideration, as is the
@@ -138,7 +224,7 @@ void initialize(void)  /* Initialization function. */
     time_next_event[2] = 1.0e+30;
     time_next_event[3] = 1.0e+30;
     time_next_event[4] = 1.0e+30;
-    time_next_event[5] = 1000;
+    time_next_event[5] = time_limit;
     
 }
 
@@ -186,6 +272,7 @@ void arrive1(void)  /* Arrival event function. */
 
         /* Server 1 is busy, so increment number of customers in first queue. */
 
+        time_avg_change(&stat_q1, num_in_q1);
         ++num_in_q1;
 
         /* Check to see whether an overflow condition exists. */
@@ -203,6 +290,7 @@ void arrive1(void)  /* Arrival event function. */
            arriving customer at the (new) end of time_arrival. */
 
         queue1[num_in_q1] = sim_time;
+        BENCH_QUEUE(num_in_q1);
     }
 
     else {
@@ -217,14 +305,16 @@ void arrive1(void)  /* Arrival event function. */
         /* Increment the number of customers delayed, and make server busy. */
 
         ++num_custs_delayed1;
+        time_avg_change(&stat_server1, server1_status);
         server1_status = BUSY;
 
         /* Schedule a a queue change event. */
 
-        time_next_event[2] = sim_time + expon(service_time1);
+        time_next_event[2] = sim_time + service(1);
     }
-    
-    //printf("ARRIVE1: %d in queue 1 and %d in queue 2, SERVER 1 STATUS: %d and SERVER 2 STATUS: %d, %d in transit\n", num_in_q1, num_in_q2, server1_status, server2_status, num_in_transit);
+
+    TRACE_EVENT(1, num_in_q1, num_in_q2, server1_status, server2_status,
+                num_in_transit);
 }
 
 void depart1(void)  /* Queue change event function. */
@@ -239,6 +329,7 @@ void depart1(void)  /* Queue change event function. */
         /* The queue is empty so make the server idle and eliminate the
            departure (service completion) event from consideration. */
 
+        time_avg_change(&stat_server1, server1_status);
         server1_status      = IDLE;
         time_next_event[2] = 1.0e+30;
     }
@@ -248,6 +339,7 @@ void depart1(void)  /* Queue change event function. */
         /* The queue is nonempty, so decrement the number of customers in
            queue. */
 
+        time_avg_change(&stat_q1, num_in_q1);
         --num_in_q1;
 
         /* Compute the delay of the customer who is beginning service and update
@@ -259,19 +351,24 @@ void depart1(void)  /* Queue change event function. */
         /* Increment the number of customers delayed, and schedule next change and arrival into second queue. */
 
         ++num_custs_delayed1;
-        time_next_event[2] = sim_time + expon(service_time1);
-        time_next_event[3] = sim_time + uniform(0.0,2.0);
+        time_next_event[2] = sim_time + service(1);
+        time_next_event[3] = sim_time + transit();
 
         /* Move each customer in queue (if any) up one place. */
 
+        INSTR_SHIFT(num_in_q1);
         for (i = 1; i <= num_in_q1; ++i)
             queue1[i] = queue1[i + 1];
     }
     
     /* Increment the current number of customers in transit. */
     
+    time_avg_change(&stat_transit, num_in_transit);
     num_in_transit += 1;
-    //printf("DEPART1: %d in queue 1 and %d in queue 2, SERVER 1 STATUS: %d and SERVER 2 STATUS: %d, %d in transit\n", num_in_q1, num_in_q2, server1_status, server2_status, num_in_transit);
+    if (num_in_transit > max_in_transit)
+        max_in_transit = num_in_transit;
+    TRACE_EVENT(2, num_in_q1, num_in_q2, server1_status, server2_status,
+                num_in_transit);
     
 }
     
@@ -281,7 +378,7 @@ void arrive2(void) {
 	
 	
 	/* Schedule next arrival from transit. */
-	time_next_event[3] = sim_time + uniform(0.0,2.0);
+	time_next_event[3] = sim_time + transit();
 
     /* Check to see whether server 2 is busy. */
 
@@ -289,6 +386,7 @@ void arrive2(void) {
 
         /* Server 2 is busy, so increment number of customers in second queue. */
 
+        time_avg_change(&stat_q2, num_in_q2);
         ++num_in_q2;
 
         /* Check to see whether an overflow condition exists. */
@@ -306,6 +404,7 @@ void arrive2(void) {
            arriving customer at the (new) end of time_arrival. */
 
         queue2[num_in_q2] = sim_time;
+        BENCH_QUEUE(num_in_q2);
     }
 
     else {
@@ -320,17 +419,19 @@ void arrive2(void) {
         /* Increment the number of customers delayed, and make server busy. */
 
         ++num_custs_delayed2;
+        time_avg_change(&stat_server2, server2_status);
         server2_status = BUSY;
 
         /* Schedule a queue departure event. */
 
-        time_next_event[4] = sim_time + expon(service_time2);
+        time_next_event[4] = sim_time + service(2);
     }
     
+    time_avg_change(&stat_transit, num_in_transit);
     num_in_transit -= 1;
-     
-    
-    //printf("ARRIVE2: %d in queue 1 and %d in queue 2, SERVER 1 STATUS: %d and SERVER 2 STATUS: %d, %d in transit\n", num_in_q1, num_in_q2, server1_status, server2_status, num_in_transit);
+
+    TRACE_EVENT(3, num_in_q1, num_in_q2, server1_status, server2_status,
+                num_in_transit);
 
     
     
@@ -349,6 +450,7 @@ void depart2(void)  /* Departure event function. */
         /* The queue is empty so make the server idle and eliminate the
            departure (service completion) event from consideration. */
 
+        time_avg_change(&stat_server2, server2_status);
         server2_status      = IDLE;
         time_next_event[4] = 1.0e+30;
     }
@@ -358,6 +460,7 @@ void depart2(void)  /* Departure event function. */
         /* The queue is nonempty, so decrement the number of customers in
            queue. */
 
+        time_avg_change(&stat_q2, num_in_q2);
         --num_in_q2;
 
         /* Compute the delay of the customer who is beginning service and update
@@ -369,21 +472,28 @@ void depart2(void)  /* Departure event function. */
         /* Increment the number of customers delayed, and schedule departure. */
 
         ++num_custs_delayed2;
-        time_next_event[4] = sim_time + expon(service_time2);
+        time_next_event[4] = sim_time + service(2);
 
         /* Move each customer in queue (if any) up one place. */
 
+        INSTR_SHIFT(num_in_q2);
         for (i = 1; i <= num_in_q2; ++i)
             queue2[i] = queue2[i + 1];
     }
-    
-    //printf("DEPART2: %d in queue 1 and %d in queue 2, SERVER 1 STATUS: %d and SERVER 2 STATUS: %d, %d in transit\n", num_in_q1, num_in_q2, server1_status, server2_status, num_in_transit);
+
+    TRACE_EVENT(4, num_in_q1, num_in_q2, server1_status, server2_status,
+                num_in_transit);
 
 }
 
 
 void report(void)  /* Report generator function. */
 {
+    /* Bring the time-average statistical accumulators up to the end of the
+       simulation. */
+
+    update_time_avg_stats();
+
     /* Compute and write estimates of desired measures of performance. */
 
     fprintf(outfile, "\n\nAverage delay in queue 1%11.3f minutes\n\n",
@@ -391,76 +501,145 @@ void report(void)  /* Report generator function. */
     fprintf(outfile, "Average delay in queue 2%11.3f minutes\n\n",
             total_of_delays2 / num_custs_delayed2);
     fprintf(outfile, "Average number in queue 1%10.3f\n\n",
-            area_num_in_q1 / sim_time);
+            stat_q1.area / sim_time);
     fprintf(outfile, "Average number in queue 2%10.3f\n\n",
-            area_num_in_q2 / sim_time);
+            stat_q2.area / sim_time);
     fprintf(outfile, "Server 1 utilization%15.3f\n\n",
-            area_server_status1 / sim_time);
+            stat_server1.area / sim_time);
     fprintf(outfile, "Server 2 utilization%15.3f\n\n",
-            area_server_status2 / sim_time);    
+            stat_server2.area / sim_time);    
     fprintf(outfile, "Maximum number in transit%14d\n\n",
             max_in_transit);     
     fprintf(outfile, "Average number in transit%15.3f\n\n",
-            total_in_transit / sim_time);
+            stat_transit.area / sim_time);
             
     fprintf(outfile, "Time simulation ended%12.3f minutes\n\n\n", sim_time);
+    INSTR_REPORT(outfile);
+
+    /* Write the parameters and measures as a machine-readable row. */
+
+    RESULTS_REAL("mean_interarrival", mean_interarrival);
+    RESULTS_REAL("service_time1", service_time1);
+    RESULTS_REAL("service_time2", service_time2);
+    RESULTS_INT("time_limit", time_limit);
+    RESULTS_REAL("avg_delay_in_queue1", total_of_delays1 / num_custs_delayed1);
+    RESULTS_REAL("avg_delay_in_queue2", total_of_delays2 / num_custs_delayed2);
+    RESULTS_REAL("avg_num_in_queue1", stat_q1.area / sim_time);
+    RESULTS_REAL("avg_num_in_queue2", stat_q2.area / sim_time);
+    RESULTS_REAL("server1_utilization", stat_server1.area / sim_time);
+    RESULTS_REAL("server2_utilization", stat_server2.area / sim_time);
+    RESULTS_INT("max_in_transit", max_in_transit);
+    RESULTS_REAL("avg_num_in_transit", stat_transit.area / sim_time);
+    RESULTS_REAL("time_end", sim_time);
+    RESULTS_ROW();
 }
 
 
-void update_time_avg_stats(void)  /* Update area accumulators for time-average
-                                     statistics. */
+void time_avg_init(struct time_avg *s)  /* Initialize a time-weighted
+                                           accumulator. */
 {
-    float time_since_last_event;
+    s->area             = 0.0;
+    s->time_last_change = sim_time;
+}
+
 
-    /* Compute time since last event, and update last-event-time marker. */
+void time_avg_change(struct time_avg *s, int value)  /* Add the area under a
+                                                        variable with the value
+                                                        "value" since its last
+                                                        change, just before it
+                                                        changes again. */
+{
+    s->area             += value * (sim_time - s->time_last_change);
+    s->time_last_change  = sim_time;
+}
 
-    time_since_last_event = sim_time - time_last_event;
-    time_last_event       = sim_time;
 
-    /* Update area under number-in-queue function. */
+void update_time_avg_stats(void)  /* Update area accumulators for time-average
+                                     statistics up to the current time. */
+{
+    /* Update areas under number-in-queue functions. */
 
-    area_num_in_q1      += num_in_q1 * time_since_last_event;
-    area_num_in_q2      += num_in_q2 * time_since_last_event;
+    time_avg_change(&stat_q1, num_in_q1);
+    time_avg_change(&stat_q2, num_in_q2);
 
-    /* Update area under server-busy indicator function. */
+    /* Update areas under server-busy indicator functions. */
 
-    area_server_status1 += server1_status * time_since_last_event;
-    area_server_status2 += server2_status * time_since_last_event;
-    
-    
-    /* Update transit stats. */
-    
-    if(num_in_transit > max_in_transit) {
-    	max_in_transit = num_in_transit;
-    }
-    
-    total_in_transit += num_in_transit * time_since_last_event;
+    time_avg_change(&stat_server1, server1_status);
+    time_avg_change(&stat_server2, server2_status);
 
+    /* Update area under number-in-transit function. */
+
+    time_avg_change(&stat_transit, num_in_transit);
 }
 
 void finish(void) 
 {
 	/* Invoke the report generator and end the simulation. */
+    TRACE_EVENT(5, num_in_q1, num_in_q2, server1_status, server2_status,
+                num_in_transit);
     report();
 }
 
 
 float expon(float mean)  /* Exponential variate generation function. */
 {
+    float x;
+
     /* Return an exponential random variate with mean "mean". */
 
-    return -mean * log(lcgrand(1));
+    INSTR_RNG_BEGIN();
+    x = -mean * log(lcgrand(1));
+    INSTR_RNG_END(1);
+    return x;
 }
 
 float uniform(float a, float b)  /* Uniform variate generation function. */
 {
+    float x;
+
     /* Return a U(a,b) random variate. */
 
-    return a + lcgrand(1) * (b - a);
+    INSTR_RNG_BEGIN();
+    x = a + lcgrand(1) * (b - a);
+    INSTR_RNG_END(1);
+    return x;
 }
 
+float service(int station)  /* Service-time variate generation function. */
+{
+    float x;
 
+    /* Exponential service times still come from expon(), so that default
+       runs draw exactly the variates they always have. */
 
+    if (service_dist[station].kind == DIST_EXPON)
+        return expon(service_dist[station].mean);
+    INSTR_RNG_BEGIN();
+    x = dist_sample(&service_dist[station], 1);
+    INSTR_RNG_END(service_dist[station].num_uniforms);
+    return x;
+}
 
+float transit(void)  /* Transit-time variate generation function. */
+{
+    float x;
 
+    /* Without a "transit" line, transit times are U(0,2) from uniform(), as
+       they always have been. */
 
+    if (transit_uniform)
+        return uniform(0.0, 2.0);
+    INSTR_RNG_BEGIN();
+    x = dist_sample(&transit_dist, 1);
+    INSTR_RNG_END(transit_dist.num_uniforms);
+    return x;
+}
+
+void describe(const char *what, struct dist *d)  /* Write a distribution
+                                                    to the report. */
+{
+    char description[64];
+
+    dist_describe(d, description, sizeof(description));
+    fprintf(outfile, "%s  %s\n\n", what, description);
+}
@@ -0,0 +1,188 @@
+/* Double-server queueing system with transit time, written as processes on
+   the coroutine engine of proc.hpp.  It reads mm2_t.in and writes the report
+   of mm2_t.c, and the memory its processes used, to mm2_tproc.out.  Each
+   customer is one process that is served at server 1, spends its own
+   U(0,2) transit time on the way to server 2, and is served there, so any
+   number of customers can be in transit at once. */
+
+#include <cmath>
+#include <cstdio>
+#include "proc.hpp"   /* Header file for the process engine. */
+extern "C" {
+#include "lcgrand.h"  /* Header file for random-number generator. */
+}
+
+struct mm2_t : proc::engine<mm2_t> {
+    int         num_custs_delayed1, num_custs_delayed2, time_limit,
+                max_in_transit, num_in_transit;
+    float       area_num_in_q1, area_num_in_q2, area_server1, area_server2,
+                area_num_in_transit, mean_interarrival, service_time1,
+                service_time2, total_of_delays1, total_of_delays2;
+    proc::server server1, server2;
+    FILE        *outfile;
+
+    void initialize()  /* Initialization function. */
+    {
+        /* Initialize the simulation clock, ending the processes of the
+           previous replication, and the state variables. */
+
+        start();
+        clear(server1);
+        clear(server2);
+        num_in_transit = 0;
+
+        /* Initialize the statistical counters. */
+
+        num_custs_delayed1  = 0;
+        num_custs_delayed2  = 0;
+        total_of_delays1    = 0.0;
+        total_of_delays2    = 0.0;
+        max_in_transit      = 0;
+        area_num_in_q1      = 0.0;
+        area_num_in_q2      = 0.0;
+        area_server1        = 0.0;
+        area_server2        = 0.0;
+        area_num_in_transit = 0.0;
+
+        /* Start the arrival process. */
+
+        activate(arrivals(), sim_time);
+    }
+
+    proc::process arrivals()  /* Arrival process: starts a customer after
+                                 each interarrival time. */
+    {
+        for (;;) {
+            co_await hold(expon(mean_interarrival));
+            activate(customer(), sim_time);
+        }
+    }
+
+    proc::process customer()  /* Customer process. */
+    {
+        float time_arrival;
+
+        /* Wait for server 1, and add the delay in queue 1 to the total. */
+
+        time_arrival = sim_time;
+        co_await request(server1);
+        total_of_delays1 += sim_time - time_arrival;
+        ++num_custs_delayed1;
+
+        /* Be served, and pass server 1 on to the next customer. */
+
+        co_await hold(expon(service_time1));
+        release(server1);
+
+        /* Travel to server 2. */
+
+        if (++num_in_transit > max_in_transit)
+            max_in_transit = num_in_transit;
+        co_await hold(uniform(0.0, 2.0));
+        --num_in_transit;
+
+        /* Wait for server 2, be served, and leave the system. */
+
+        time_arrival = sim_time;
+        co_await request(server2);
+        total_of_delays2 += sim_time - time_arrival;
+        ++num_custs_delayed2;
+        co_await hold(expon(service_time2));
+        release(server2);
+    }
+
+    void update_time_avg_stats(float time_since_last_event)  /* Update area
+                                   accumulators for time-average statistics. */
+    {
+        area_num_in_q1      += server1.num_in_q * time_since_last_event;
+        area_num_in_q2      += server2.num_in_q * time_since_last_event;
+        area_server1        += server1.status * time_since_last_event;
+        area_server2        += server2.status * time_since_last_event;
+        area_num_in_transit += num_in_transit * time_since_last_event;
+    }
+
+    void report()  /* Report generator function. */
+    {
+        std::fprintf(outfile, "\n\nAverage delay in queue 1%11.3f minutes\n\n",
+                     total_of_delays1 / num_custs_delayed1);
+        std::fprintf(outfile, "Average delay in queue 2%11.3f minutes\n\n",
+                     total_of_delays2 / num_custs_delayed2);
+        std::fprintf(outfile, "Average number in queue 1%10.3f\n\n",
+                     area_num_in_q1 / sim_time);
+        std::fprintf(outfile, "Average number in queue 2%10.3f\n\n",
+                     area_num_in_q2 / sim_time);
+        std::fprintf(outfile, "Server 1 utilization%15.3f\n\n",
+                     area_server1 / sim_time);
+        std::fprintf(outfile, "Server 2 utilization%15.3f\n\n",
+                     area_server2 / sim_time);
+        std::fprintf(outfile, "Maximum number in transit%14d\n\n",
+                     max_in_transit);
+        std::fprintf(outfile, "Average number in transit%15.3f\n\n",
+                     area_num_in_transit / sim_time);
+        std::fprintf(outfile, "Time simulation ended%12.3f minutes\n\n\n",
+                     sim_time);
+    }
+
+    static float expon(float mean)  /* Exponential variate generation
+                                       function. */
+    {
+        return -mean * std::log(static_cast<double>(lcgrand(1)));
+    }
+
+    static float uniform(float a, float b)  /* Uniform variate generation
+                                               function. */
+    {
+        return a + lcgrand(1) * (b - a);
+    }
+};
+
+static mm2_t model;
+
+
+int main()  /* Main function. */
+{
+    int  i;
+    FILE *infile;
+
+    /* Open input and output files, and read input parameters. */
+
+    infile        = std::fopen("mm2_t.in",  "r");
+    model.outfile = std::fopen("mm2_tproc.out", "w");
+    std::fscanf(infile, "%f %f %f %d", &model.mean_interarrival,
+                &model.service_time1, &model.service_time2, &model.time_limit);
+
+    /* Write report heading and input parameters. */
+
+    std::fprintf(model.outfile,
+                 "Double-server queueing system with transit time\n\n");
+    std::fprintf(model.outfile, "Mean interarrival time%11.3f minutes\n\n",
+                 model.mean_interarrival);
+    std::fprintf(model.outfile, "Mean service time for server 1%16.3f minutes\n\n",
+                 model.service_time1);
+    std::fprintf(model.outfile, "Mean service time for server 2%16.3f minutes\n\n",
+                 model.service_time2);
+    std::fprintf(model.outfile, "Time limit%14d\n\n", model.time_limit);
+
+    /* Run 10 replications, each until the time limit. */
+
+    BENCH_START();
+    for (i = 0; i < 10; ++i) {
+        model.initialize();
+        model.run(model.time_limit);
+        model.report();
+    }
+    BENCH_STOP();
+
+    /* Write the memory used by the processes. */
+
+    std::fprintf(model.outfile, "Largest process frame%14zu bytes\n\n",
+                 proc::pool.largest_frame);
+    std::fprintf(model.outfile, "Maximum number of processes%8zu\n\n",
+                 proc::pool.max_frames);
+    std::fprintf(model.outfile, "Frame pool size%20zu bytes\n",
+                 proc::pool.bytes_reserved);
+
+    std::fclose(infile);
+    std::fclose(model.outfile);
+    return 0;
+}
@@ -0,0 +1,345 @@
+/* Process-interaction simulation on C++20 coroutines.  Each entity is written
+   as one coroutine that follows its whole life through the system, instead
+   of being split across event functions, and it suspends wherever simulated
+   time must pass or a server is busy.  A model is a class derived from
+   proc::engine<Model> that defines
+       void update_time_avg_stats(float time_since_last_event),
+       FILE *outfile                                   for error messages,
+   and whose processes are member functions returning proc::process, e.g.
+       proc::process customer()
+       {
+           co_await hold(expon(mean_service));
+       }
+   The event list is a binary heap of (time, process) pairs, ties going to the
+   process scheduled first.  Coroutine frames come from a pool of free lists,
+   one per 16-byte size class, that is refilled a chunk of frames at a time
+   and never returned to the system, so starting and ending a process costs a
+   few instructions, and a suspended process costs its frame and a 16-byte
+   event-list entry.  A process waiting for a server is linked into the
+   server's queue through its own frame, so that queue costs nothing more.
+   This file (named proc.hpp) should be included in any model using the
+   engine by executing
+       #include "proc.hpp"
+   before referencing it, and compiled with -std=c++20.
+
+   Usage, within the model:
+       activate(p, t)       starts process p at time t,
+       co_await hold(t)     suspends the process for t units of time,
+       co_await request(s)  waits until server s is idle and makes it busy,
+       release(s)           passes server s to the first process waiting for
+                            it, or makes it idle,
+       step()               resumes the next process, and
+       run(t)               resumes processes until the clock would pass time
+                            t, and then advances the clock to t. */
+
+#ifndef PROC_HPP
+#define PROC_HPP
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "bench.h"  /* Header file for benchmark hooks. */
+
+namespace proc {
+
+class frame_pool {  /* Free lists of coroutine frames by size class. */
+public:
+    static constexpr std::size_t granule          = 16,
+                                 num_classes      = 64,
+                                 frames_per_chunk = 256;
+
+    std::size_t num_frames, max_frames, largest_frame, bytes_reserved;
+
+    void *allocate(std::size_t size)  /* Return a frame of size bytes. */
+    {
+        std::size_t c = (size + granule - 1) / granule;
+        node        *frame;
+
+        if (++num_frames > max_frames)
+            max_frames = num_frames;
+        if (size > largest_frame)
+            largest_frame = size;
+
+        /* Frames too large for a size class come from the heap. */
+
+        if (c >= num_classes)
+            return ::operator new(size);
+
+        /* Take the first frame of the class, carving a new chunk into frames
+           if there is none. */
+
+        if (free_list[c] == nullptr)
+            refill(c);
+        frame         = free_list[c];
+        free_list[c]  = frame->next;
+        return frame;
+    }
+
+    void deallocate(void *p, std::size_t size)  /* Return a frame to its
+                                                   free list. */
+    {
+        std::size_t c = (size + granule - 1) / granule;
+        node        *frame;
+
+        --num_frames;
+        if (c >= num_classes) {
+            ::operator delete(p);
+            return;
+        }
+        frame         = static_cast<node *>(p);
+        frame->next   = free_list[c];
+        free_list[c]  = frame;
+    }
+
+private:
+    struct node {
+        node *next;
+    };
+
+    node *free_list[num_classes];
+
+    void refill(std::size_t c)  /* Carve a chunk into frames of class c. */
+    {
+        std::size_t i, frame_size = c * granule;
+        char        *chunk;
+
+        chunk = static_cast<char *>(::operator new(frames_per_chunk * frame_size));
+        bytes_reserved += frames_per_chunk * frame_size;
+        for (i = frames_per_chunk; i-- > 0;) {
+            node *frame  = reinterpret_cast<node *>(chunk + i * frame_size);
+            frame->next  = free_list[c];
+            free_list[c] = frame;
+        }
+    }
+};
+
+inline frame_pool pool;  /* The pool all process frames come from. */
+
+class process {  /* A coroutine that runs as a simulated entity. */
+public:
+    struct promise_type {
+
+        /* A process does not run until it is activated, and its frame goes
+           back to the pool as soon as it finishes. */
+
+        process get_return_object()
+        {
+            return process(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never  final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::abort(); }
+
+        static void *operator new(std::size_t size)
+        {
+            return pool.allocate(size);
+        }
+        static void operator delete(void *p, std::size_t size)
+        {
+            pool.deallocate(p, size);
+        }
+    };
+
+    std::coroutine_handle<> handle;
+
+private:
+    explicit process(std::coroutine_handle<> h) : handle(h) {}
+};
+
+#define BUSY      1  /* Mnemonics for server's being busy */
+#define IDLE      0  /* and idle. */
+
+struct request_awaiter;
+
+struct server {  /* A single server and the processes waiting for it. */
+    int             status, num_in_q;
+    request_awaiter *first, *last;
+
+    server() : status(IDLE), num_in_q(0), first(nullptr), last(nullptr) {}
+};
+
+struct request_awaiter {  /* Kept in the frame of the requesting process,
+                             which links it into the server's queue. */
+    server                  *s;
+    request_awaiter         *next;
+    std::coroutine_handle<> handle;
+
+    bool await_ready()  /* Seize the server at once if it is idle. */
+    {
+        if (s->status == IDLE) {
+            s->status = BUSY;
+            return true;
+        }
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> h)  /* Join the end of the
+                                                      queue. */
+    {
+        handle = h;
+        next   = nullptr;
+        if (s->last != nullptr)
+            s->last->next = this;
+        else
+            s->first = this;
+        s->last = this;
+        ++s->num_in_q;
+        BENCH_QUEUE(s->num_in_q);
+    }
+
+    void await_resume() {}
+};
+
+template <class Model>
+class engine {
+public:
+    float sim_time, time_last_event;
+
+    struct hold_awaiter {
+        engine *e;
+        float  time;
+
+        bool await_ready() { return false; }
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            e->schedule(h, e->sim_time + time);
+        }
+        void await_resume() {}
+    };
+
+    void start()  /* Set the clock to zero and end every process. */
+    {
+        for (const entry &x : event_list)
+            x.handle.destroy();
+        event_list.clear();
+        sim_time        = 0.0;
+        time_last_event = 0.0;
+        num_scheduled   = 0;
+    }
+
+    void clear(server &s)  /* End every process waiting for s, and make it
+                              idle. */
+    {
+        request_awaiter *r, *next;
+
+        for (r = s.first; r != nullptr; r = next) {
+            next = r->next;
+            r->handle.destroy();
+        }
+        s = server();
+    }
+
+    void activate(process p, float time)  /* Start process p at time. */
+    {
+        schedule(p.handle, time);
+    }
+
+    hold_awaiter hold(float time)  /* Suspend for time units. */
+    {
+        return hold_awaiter{this, time};
+    }
+
+    request_awaiter request(server &s)  /* Wait until s is idle and seize
+                                           it. */
+    {
+        return request_awaiter{&s, nullptr, nullptr};
+    }
+
+    void release(server &s)  /* Pass s to the first process waiting, or make
+                                it idle. */
+    {
+        request_awaiter *r = s.first;
+
+        if (r == nullptr) {
+            s.status = IDLE;
+            return;
+        }
+
+        /* The server stays busy, and the first process resumes now, after
+           the current process suspends. */
+
+        s.first = r->next;
+        if (s.first == nullptr)
+            s.last = nullptr;
+        --s.num_in_q;
+        schedule(r->handle, sim_time);
+    }
+
+    void step()  /* Resume the next process. */
+    {
+        entry next;
+
+        /* Check to see whether the event list is empty. */
+
+        if (event_list.empty()) {
+            std::fprintf(model().outfile, "\nEvent list empty at time %f",
+                         sim_time);
+            std::exit(1);
+        }
+
+        /* Remove the next process, advance the simulation clock, and update
+           the time-average statistical accumulators. */
+
+        std::pop_heap(event_list.begin(), event_list.end(), later);
+        next = event_list.back();
+        event_list.pop_back();
+        advance(next.time);
+        BENCH_EVENT();
+
+        /* Resume the process until it suspends again. */
+
+        next.handle.resume();
+    }
+
+    void run(float time_end)  /* Run until time_end. */
+    {
+        while (event_list.empty() || event_list.front().time <= time_end)
+            step();
+        advance(time_end);
+    }
+
+private:
+    struct entry {
+        float                   time;
+        unsigned                seq;
+        std::coroutine_handle<> handle;
+    };
+
+    std::vector<entry> event_list;
+    unsigned           num_scheduled;
+
+    static bool later(const entry &a, const entry &b)  /* Heap order. */
+    {
+        return a.time > b.time || (a.time == b.time && a.seq > b.seq);
+    }
+
+    void schedule(std::coroutine_handle<> h, float time)  /* Resume h at
+                                                             time. */
+    {
+        event_list.push_back(entry{time, num_scheduled++, h});
+        std::push_heap(event_list.begin(), event_list.end(), later);
+    }
+
+    void advance(float time)  /* Advance the clock to time. */
+    {
+        float time_since_last_event = time - time_last_event;
+
+        sim_time        = time;
+        time_last_event = time;
+        model().update_time_avg_stats(time_since_last_event);
+    }
+
+    Model &model()  /* Return the model this engine runs. */
+    {
+        return static_cast<Model &>(*this);
+    }
+};
+
+}  // namespace proc
+
+#endif
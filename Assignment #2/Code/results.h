@@ -0,0 +1,349 @@
+/* Machine-readable results for the simulation models.  When a model is
+   compiled with -DRESULTS, the hooks below write one row per replication,
+   holding the replication index (counted from 0 within a configuration, so
+   always 0 for a model that runs each configuration once), the seeds of the
+   random-number streams at its start, the input parameters and the measures
+   of performance, to three files
+   alongside the formatted report:
+       model.csv    comma-separated values, with a heading line,
+       model.jsonl  one JSON object per line, with null for a measure that
+                    is not finite, and
+       model.col    a packed binary columnar file: a struct results_header, a
+                    struct results_column for each column, and then each column
+                    in turn as num_rows doubles (integer columns hold exact
+                    integers).
+   The text files are written through large stdio buffers, and the columnar
+   file is written column by column when the results are closed.  Without
+   -DRESULTS the hooks expand to nothing.  This file (named results.h) should
+   be included in the model by executing
+       #include "results.h"
+   and the hooks used as
+       RESULTS_OPEN(model, num_streams);  before the first replication, with
+                                          model the base name of the files and
+                                          num_streams the number of streams
+                                          used,
+       RESULTS_START(replication);        before initialize(),
+       RESULTS_INT(name, value);          in report(), for each integer
+       RESULTS_REAL(name, value);         and real parameter and measure,
+       RESULTS_ROW();                     after the last of these, and
+       RESULTS_CLOSE();                   after the last replication.
+   Every row must have the same columns, in the same order.  A model that
+   checkpoints its run also uses
+       RESULTS_SAVE(file);                when it writes a checkpoint, to add
+                                          the rows written so far, the row in
+                                          progress and the lengths of the text
+                                          files to it,
+       RESULTS_LOAD(file)                 when it reads a checkpoint, which
+                                          restores them and is 1, or is 0 if
+                                          the checkpoint has none, and
+       RESULTS_REOPEN(model, num_streams);
+                                          instead of RESULTS_OPEN when it
+                                          resumes the run, cutting the text
+                                          files back to those lengths and
+                                          appending to them.
+   RESULTS_SAVED is 1 when compiled with -DRESULTS, and 0 otherwise, so that
+   a checkpoint can record whether it holds the results. */
+
+#ifndef RESULTS_H
+#define RESULTS_H
+
+#include <stdint.h>
+
+#define RESULTS_MAGIC        0x4c4f4353UL  /* "SCOL" in little-endian order. */
+#define RESULTS_VERSION      1
+#define RESULTS_NAME_LENGTH  32
+#define RESULTS_INTEGER      0  /* Column types. */
+#define RESULTS_DOUBLE       1
+
+struct results_header {  /* Columnar file header. */
+    uint32_t magic, version, num_columns, reserved;
+    uint64_t num_rows;
+    char     model[RESULTS_NAME_LENGTH];
+};
+
+struct results_column {  /* Columnar file column description. */
+    char     name[RESULTS_NAME_LENGTH];
+    uint32_t type, reserved;
+};
+
+struct results_state {  /* Checkpoint record, followed by num_columns
+                           struct results_column, column doubles of the row
+                           in progress, and num_rows * num_columns doubles of
+                           the rows written. */
+    int32_t num_columns, column;
+    int64_t num_rows, csv_length, json_length;
+};
+
+#ifdef RESULTS
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "lcgrand.h"
+
+#define RESULTS_COLUMN_LIMIT 64       /* Limit on number of columns. */
+#define RESULTS_BUFFER       (1 << 20)
+
+static char    results_model[RESULTS_NAME_LENGTH];
+static FILE   *results_csv, *results_json, *results_col;
+static struct results_column results_columns[RESULTS_COLUMN_LIMIT];
+static double  results_values[RESULTS_COLUMN_LIMIT], *results_table;
+static int     results_num_columns, results_column, results_num_streams;
+static long    results_num_rows, results_capacity, results_csv_length,
+               results_json_length;
+
+static FILE *results_file(const char *suffix, const char *mode)  /* Open a
+                                                                    file. */
+{
+    char  path[RESULTS_NAME_LENGTH + 8];
+    FILE *file;
+
+    snprintf(path, sizeof(path), "%s.%s", results_model, suffix);
+    file = fopen(path, mode);
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open results file %s\n", path);
+        exit(3);
+    }
+    setvbuf(file, NULL, _IOFBF, RESULTS_BUFFER);
+    return file;
+}
+
+static void results_open(const char *model, int num_streams)  /* Open the
+                                                                 files. */
+{
+    snprintf(results_model, RESULTS_NAME_LENGTH, "%s", model);
+    results_csv         = results_file("csv", "w");
+    results_json        = results_file("jsonl", "w");
+    results_col         = results_file("col", "wb");
+    results_num_streams = num_streams;
+    results_num_columns = 0;
+    results_num_rows    = 0;
+}
+
+static inline void results_reopen(const char *model, int num_streams)
+    /* Reopen the files of an interrupted run. */
+{
+    snprintf(results_model, RESULTS_NAME_LENGTH, "%s", model);
+    results_csv  = results_file("csv", "r+");
+    results_json = results_file("jsonl", "r+");
+    if (ftruncate(fileno(results_csv), results_csv_length) != 0 ||
+        ftruncate(fileno(results_json), results_json_length) != 0) {
+        fprintf(stderr, "Cannot resume the results of %s\n", model);
+        exit(3);
+    }
+    fseek(results_csv, results_csv_length, SEEK_SET);
+    fseek(results_json, results_json_length, SEEK_SET);
+    results_col         = results_file("col", "wb");
+    results_num_streams = num_streams;
+}
+
+static inline void results_save(FILE *file)  /* Add the results so far
+                                                to a checkpoint. */
+{
+    struct results_state state;
+
+    fflush(results_csv);
+    fflush(results_json);
+    state.num_columns = results_num_columns;
+    state.column      = results_column;
+    state.num_rows    = results_num_rows;
+    state.csv_length  = ftell(results_csv);
+    state.json_length = ftell(results_json);
+    fwrite(&state, sizeof(state), 1, file);
+    fwrite(results_columns, sizeof(struct results_column),
+           results_num_columns, file);
+    fwrite(results_values, sizeof(double), results_column, file);
+    fwrite(results_table, sizeof(double),
+           results_num_rows * results_num_columns, file);
+}
+
+static inline int results_load(FILE *file)  /* Restore the results from
+                                               a checkpoint, and return 1,
+                                               or return 0. */
+{
+    struct results_state state;
+    size_t               n;
+
+    if (fread(&state, sizeof(state), 1, file) != 1 ||
+        state.num_columns < 0 || state.num_columns > RESULTS_COLUMN_LIMIT ||
+        state.column < 0 || state.column > RESULTS_COLUMN_LIMIT ||
+        state.num_rows < 0 ||
+        fread(results_columns, sizeof(struct results_column),
+              state.num_columns, file) != (size_t) state.num_columns ||
+        fread(results_values, sizeof(double), state.column, file) !=
+        (size_t) state.column)
+        return 0;
+    n                = state.num_rows * state.num_columns;
+    results_capacity = state.num_rows > 64 ? state.num_rows : 64;
+    results_table    = realloc(results_table, results_capacity *
+                               RESULTS_COLUMN_LIMIT * sizeof(double));
+    if (results_table == NULL || fread(results_table, sizeof(double), n, file)
+                                 != n)
+        return 0;
+    results_num_columns = state.num_columns;
+    results_column      = state.column;
+    results_num_rows    = state.num_rows;
+    results_csv_length  = state.csv_length;
+    results_json_length = state.json_length;
+    return 1;
+}
+
+static void results_value(const char *name, int type, double value)  /* Add
+                                                        a value to the row. */
+{
+    if (results_column == RESULTS_COLUMN_LIMIT) {
+        fprintf(stderr, "Too many results columns\n");
+        exit(3);
+    }
+
+    /* The first row determines the columns. */
+
+    if (results_num_rows == 0) {
+        snprintf(results_columns[results_column].name, RESULTS_NAME_LENGTH,
+                 "%s", name);
+        results_columns[results_column].type     = type;
+        results_columns[results_column].reserved = 0;
+        results_num_columns = results_column + 1;
+    }
+    results_values[results_column++] = value;
+}
+
+static void results_start(int replication)  /* Start the row of a
+                                               replication. */
+{
+    char name[RESULTS_NAME_LENGTH];
+    int  stream;
+
+    results_column = 0;
+    results_value("replication", RESULTS_INTEGER, replication);
+    for (stream = 1; stream <= results_num_streams; ++stream) {
+        snprintf(name, sizeof(name), "seed_%d", stream);
+        results_value(name, RESULTS_INTEGER, lcgrandgt(stream));
+    }
+}
+
+static void results_row(void)  /* Write the row. */
+{
+    int j;
+
+    if (results_column != results_num_columns) {
+        fprintf(stderr, "Results row has %d columns, not %d\n",
+                results_column, results_num_columns);
+        exit(3);
+    }
+
+    /* Write the CSV heading with the first row. */
+
+    if (results_num_rows == 0)
+        for (j = 0; j < results_num_columns; ++j)
+            fprintf(results_csv, "%s%c", results_columns[j].name,
+                    j + 1 < results_num_columns ? ',' : '\n');
+
+    /* Write the CSV and JSON lines. */
+
+    fprintf(results_json, "{\"model\":\"%s\"", results_model);
+    for (j = 0; j < results_num_columns; ++j) {
+        if (results_columns[j].type == RESULTS_INTEGER) {
+            fprintf(results_csv, "%ld", (long) results_values[j]);
+            fprintf(results_json, ",\"%s\":%ld", results_columns[j].name,
+                    (long) results_values[j]);
+        }
+        else {
+
+            /* JSON has no NaN or infinity, e.g. for an average delay when no
+               customer was delayed, so such values are written as null. */
+
+            fprintf(results_csv, "%.9g", results_values[j]);
+            if (isfinite(results_values[j]))
+                fprintf(results_json, ",\"%s\":%.9g",
+                        results_columns[j].name, results_values[j]);
+            else
+                fprintf(results_json, ",\"%s\":null",
+                        results_columns[j].name);
+        }
+        fputc(j + 1 < results_num_columns ? ',' : '\n', results_csv);
+    }
+    fputs("}\n", results_json);
+
+    /* Keep the row for the columnar file. */
+
+    if (results_num_rows == results_capacity) {
+        results_capacity = results_capacity ? 2 * results_capacity : 64;
+        results_table = realloc(results_table, results_capacity *
+                                results_num_columns * sizeof(double));
+        if (results_table == NULL) {
+            fprintf(stderr, "Cannot allocate results table\n");
+            exit(3);
+        }
+    }
+    memcpy(&results_table[results_num_rows++ * results_num_columns],
+           results_values, results_num_columns * sizeof(double));
+}
+
+static void results_close(void)  /* Write the columnar file and close the
+                                    files. */
+{
+    struct results_header header;
+    double *column;
+    long    i;
+    int     j;
+
+    memset(&header, 0, sizeof(header));
+    header.magic       = RESULTS_MAGIC;
+    header.version     = RESULTS_VERSION;
+    header.num_columns = results_num_columns;
+    header.num_rows    = results_num_rows;
+    memcpy(header.model, results_model, RESULTS_NAME_LENGTH);
+    fwrite(&header, sizeof(header), 1, results_col);
+    fwrite(results_columns, sizeof(struct results_column),
+           results_num_columns, results_col);
+
+    /* Transpose the rows into columns. */
+
+    column = malloc((results_num_rows + 1) * sizeof(double));
+    for (j = 0; j < results_num_columns; ++j) {
+        for (i = 0; i < results_num_rows; ++i)
+            column[i] = results_table[i * results_num_columns + j];
+        fwrite(column, sizeof(double), results_num_rows, results_col);
+    }
+    free(column);
+    free(results_table);
+    results_table    = NULL;
+    results_capacity = 0;
+
+    fclose(results_csv);
+    fclose(results_json);
+    fclose(results_col);
+}
+
+#define RESULTS_OPEN(model, num_streams) results_open(model, num_streams)
+#define RESULTS_START(replication)       results_start(replication)
+#define RESULTS_INT(name, value) \
+    results_value(name, RESULTS_INTEGER, (double) (value))
+#define RESULTS_REAL(name, value) \
+    results_value(name, RESULTS_DOUBLE, (double) (value))
+#define RESULTS_ROW()                    results_row()
+#define RESULTS_CLOSE()                  results_close()
+#define RESULTS_SAVE(file)               results_save(file)
+#define RESULTS_LOAD(file)               results_load(file)
+#define RESULTS_REOPEN(model, num_streams) results_reopen(model, num_streams)
+#define RESULTS_SAVED                    1
+
+#else
+
+#define RESULTS_OPEN(model, num_streams)
+#define RESULTS_START(replication)
+#define RESULTS_INT(name, value)
+#define RESULTS_REAL(name, value)
+#define RESULTS_ROW()
+#define RESULTS_CLOSE()
+#define RESULTS_SAVE(file)
+#define RESULTS_LOAD(file)               1
+#define RESULTS_REOPEN(model, num_streams)
+#define RESULTS_SAVED                    0
+
+#endif
+
+#endif
@@ -0,0 +1,209 @@
+/* Asynchronous writer for the binary event tracer.  See trace.h for usage. */
+
+#ifndef TRACE
+#define TRACE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "trace.h"  /* Header file for this module. */
+
+#define TRACE_BATCH     4096  /* Most records written by one fwrite. */
+#define TRACE_MAX_BYTES   32  /* Most bytes of an encoded record, with the
+                                 start of a replication. */
+
+struct trace_record trace_ring[TRACE_CAPACITY];
+_Atomic unsigned long trace_head, trace_tail;
+int trace_replication, trace_sync;
+
+static FILE                *trace_file;
+static pthread_t            trace_thread;
+static atomic_int           trace_done;
+static struct trace_record  trace_last;
+static int                  trace_last_replication;
+static unsigned char        trace_bytes[TRACE_BATCH * TRACE_MAX_BYTES];
+
+static void          *trace_writer(void *arg);
+static void           trace_write(unsigned long tail, unsigned long n);
+static unsigned char *put_varint(unsigned char *p, int64_t v);
+static int            packed(int32_t change);
+
+
+void trace_open(const char *path)  /* Open the trace file and start the
+                                      writer thread. */
+{
+    struct trace_header header;
+
+    trace_file = fopen(path, "wb");
+    if (trace_file == NULL) {
+        fprintf(stderr, "Cannot open trace file %s\n", path);
+        exit(3);
+    }
+    setvbuf(trace_file, NULL, _IOFBF, 1 << 20);
+    header.magic       = TRACE_MAGIC;
+    header.version     = TRACE_VERSION;
+    header.record_size = sizeof(struct trace_record);
+    header.reserved    = 0;
+    fwrite(&header, sizeof(header), 1, trace_file);
+
+    atomic_store(&trace_head, 0);
+    atomic_store(&trace_tail, 0);
+    atomic_store(&trace_done, 0);
+    trace_last_replication = -1;
+
+    /* Without a writer thread, the model writes the buffer itself whenever
+       it fills. */
+
+    trace_sync = pthread_create(&trace_thread, NULL, trace_writer, NULL) != 0;
+    if (trace_sync)
+        fprintf(stderr, "Cannot start the trace writer thread; writing the"
+                " trace synchronously\n");
+
+    /* Flush the trace even if the model stops with exit(), e.g. on queue
+       overflow. */
+
+    atexit(trace_close);
+}
+
+
+void trace_close(void)  /* Drain the buffer, stop the writer thread and close
+                           the trace file. */
+{
+    /* Do nothing if the trace is already closed, as it is at exit after a
+       normal TRACE_CLOSE(). */
+
+    if (trace_file == NULL)
+        return;
+    if (trace_sync)
+        trace_drain();
+    else {
+        atomic_store_explicit(&trace_done, 1, memory_order_release);
+        pthread_join(trace_thread, NULL);
+    }
+    fclose(trace_file);
+    trace_file = NULL;
+}
+
+
+void trace_drain(void)  /* Write all the records in the buffer, in the
+                          producer's thread. */
+{
+    unsigned long head, tail, n;
+
+    head = atomic_load_explicit(&trace_head, memory_order_relaxed);
+    tail = atomic_load_explicit(&trace_tail, memory_order_relaxed);
+    while (tail != head) {
+        n = head - tail;
+        if (n > TRACE_BATCH)
+            n = TRACE_BATCH;
+        trace_write(tail, n);
+        tail += n;
+    }
+    atomic_store_explicit(&trace_tail, tail, memory_order_release);
+}
+
+
+static void *trace_writer(void *arg)  /* Writer thread function. */
+{
+    unsigned long   head, tail, n;
+    int             done;
+    struct timespec pause = { 0, 100000 };
+
+    (void) arg;
+    tail = atomic_load_explicit(&trace_tail, memory_order_relaxed);
+    for (;;) {
+
+        /* Check for completion before looking at the head, so that records
+           appended just before trace_close() are still written. */
+
+        done = atomic_load_explicit(&trace_done, memory_order_acquire);
+        head = atomic_load_explicit(&trace_head, memory_order_acquire);
+        if (head == tail) {
+            if (done)
+                break;
+            nanosleep(&pause, NULL);
+            continue;
+        }
+
+        /* Write the records available, and then release their slots to the
+           producer. */
+
+        n = head - tail;
+        if (n > TRACE_BATCH)
+            n = TRACE_BATCH;
+        trace_write(tail, n);
+        tail += n;
+        atomic_store_explicit(&trace_tail, tail, memory_order_release);
+    }
+    return NULL;
+}
+
+
+static void trace_write(unsigned long tail, unsigned long n)  /* Encode and
+                                             write n records from the buffer,
+                                             starting at record tail. */
+{
+    unsigned long        i;
+    int32_t              d1, d2, dt;
+    uint32_t             bits, last_bits;
+    unsigned char        *p, flag;
+    struct trace_record  *r;
+
+    /* Encode each record as its change from the previous one (see trace.h),
+       starting a replication from a zero record. */
+
+    p = trace_bytes;
+    for (i = 0; i < n; ++i) {
+        r = &trace_ring[(tail + i) & (TRACE_CAPACITY - 1)];
+        if (r->replication != trace_last_replication) {
+            *p++ = 0;
+            p    = put_varint(p, r->replication);
+            memset(&trace_last, 0, sizeof(trace_last));
+            trace_last_replication = r->replication;
+        }
+        d1   = r->num_in_q1 - trace_last.num_in_q1;
+        d2   = r->num_in_q2 - trace_last.num_in_q2;
+        dt   = r->num_in_transit - trace_last.num_in_transit;
+        flag = r->event_type | r->server_status << 3;
+        if (packed(d1) >= 0 && packed(d2) >= 0 && packed(dt) >= 0) {
+            *p++ = flag;
+            *p++ = packed(d1) | packed(d2) << 2 | packed(dt) << 4;
+        }
+        else {
+            *p++ = flag | 0x20;
+            p    = put_varint(p, d1);
+            p    = put_varint(p, d2);
+            p    = put_varint(p, dt);
+        }
+        memcpy(&bits, &r->sim_time, sizeof(bits));
+        memcpy(&last_bits, &trace_last.sim_time, sizeof(last_bits));
+        p          = put_varint(p, (int64_t) bits - last_bits);
+        trace_last = *r;
+    }
+    fwrite(trace_bytes, 1, p - trace_bytes, trace_file);
+}
+
+
+static unsigned char *put_varint(unsigned char *p, int64_t v)  /* Append v
+                                           as a zigzag varint, and return the
+                                           end of it. */
+{
+    uint64_t u;
+
+    u = ((uint64_t) v << 1) ^ (uint64_t) (v >> 63);
+    while (u >= 0x80) {
+        *p++ = (unsigned char) (u | 0x80);
+        u  >>= 7;
+    }
+    *p++ = (unsigned char) u;
+    return p;
+}
+
+
+static int packed(int32_t change)  /* Return the 2-bit code of a change of
+                                      -1, 0 or +1, or -1 for another. */
+{
+    return change == 0 ? 0 : change == 1 ? 1 : change == -1 ? 2 : -1;
+}
@@ -0,0 +1,117 @@
+/* Binary event tracer for the double-server queueing system with transit
+   time.  When mm2_t.c is compiled with -DTRACE (and linked with trace.c and
+   -pthread), every event appends a fixed-size record of the simulation time,
+   event type, replication, queue lengths, number in transit and server
+   statuses to a lock-free single-producer ring buffer.  A background thread
+   drains the buffer to a binary file, which tracedump decodes; if the thread
+   cannot be started, the model drains the buffer itself whenever it fills.
+   Without -DTRACE the hooks expand to nothing.  This file (named trace.h) should be
+   included in the model by executing
+       #include "trace.h"
+   and the hooks used as
+       TRACE_OPEN(path);                  before the first event,
+       TRACE_REPLICATION(i);              at the start of replication i,
+       TRACE_EVENT(type, q1, q2, s1, s2, transit);
+                                          after each event, and
+       TRACE_CLOSE();                     after the last event.
+   A model that stops early with exit() still gets its whole trace, since
+   TRACE_OPEN registers TRACE_CLOSE to run at exit. */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#define TRACE_MAGIC   0x5432324dUL  /* "MM2T" in little-endian order. */
+#define TRACE_VERSION 2
+
+/* The file holds the header and then each record encoded as a change from
+   the one before it, in 3 to 4 bytes for most events rather than the 20 of a
+   record:
+       a flag byte, with the event type in bits 0-2, the server statuses in
+       bits 3-4, and bit 5 set if the changes in the queue lengths and number
+       in transit are written as three varints rather than packed in one
+       byte;
+       the changes, either packed 2 bits each (0 for none, 1 for +1, 2 for
+       -1), number in queue 1 in bits 0-1, in queue 2 in bits 2-3 and in
+       transit in bits 4-5, or as three varints; and
+       the change in the bit pattern of the simulation time, as a varint, so
+       that the time is restored exactly.
+   Varints hold a signed integer in zigzag form, 7 bits a byte from the
+   least significant, with the top bit set in every byte but the last.  A
+   flag byte of 0 starts a replication, whose number follows as a varint;
+   the records after it are changes from a zero record. */
+
+struct trace_header {  /* File header. */
+    uint32_t magic, version, record_size, reserved;
+};
+
+struct trace_record {  /* One event, as held in the ring buffer and returned
+                          by the decoder; 20 bytes, no padding. */
+    float    sim_time;
+    int32_t  num_in_q1, num_in_q2, num_in_transit;
+    uint16_t replication;
+    uint8_t  event_type, server_status;  /* Bit 0 server 1, bit 1 server 2. */
+};
+
+#ifdef TRACE
+
+#include <sched.h>
+#include <stdatomic.h>
+
+#define TRACE_CAPACITY (1 << 16)  /* Ring-buffer records; a power of 2. */
+
+extern struct trace_record trace_ring[TRACE_CAPACITY];
+extern _Atomic unsigned long trace_head, trace_tail;
+extern int trace_replication, trace_sync;
+
+void trace_open(const char *path);
+void trace_close(void);
+void trace_drain(void);
+
+static inline void trace_put(int type, float sim_time, int q1, int q2, int s1,
+                             int s2, int transit)  /* Append one record. */
+{
+    unsigned long       head;
+    struct trace_record *r;
+
+    /* Only this thread advances the head.  Wait while the buffer is full,
+       i.e., while the writer is a whole buffer behind, giving up the processor
+       so that the writer can run, or, without a writer thread, write the
+       buffer out now. */
+
+    head = atomic_load_explicit(&trace_head, memory_order_relaxed);
+    while (head - atomic_load_explicit(&trace_tail, memory_order_acquire) >=
+           TRACE_CAPACITY) {
+        if (trace_sync)
+            trace_drain();
+        else
+            sched_yield();
+    }
+    r = &trace_ring[head & (TRACE_CAPACITY - 1)];
+    r->sim_time       = sim_time;
+    r->num_in_q1      = q1;
+    r->num_in_q2      = q2;
+    r->num_in_transit = transit;
+    r->replication    = trace_replication;
+    r->event_type     = type;
+    r->server_status  = (s1 ? 1 : 0) | (s2 ? 2 : 0);
+    atomic_store_explicit(&trace_head, head + 1, memory_order_release);
+}
+
+#define TRACE_OPEN(path)      trace_open(path)
+#define TRACE_REPLICATION(i)  (trace_replication = (i))
+#define TRACE_EVENT(type, q1, q2, s1, s2, transit) \
+    trace_put(type, sim_time, q1, q2, s1, s2, transit)
+#define TRACE_CLOSE()         trace_close()
+
+#else
+
+#define TRACE_OPEN(path)
+#define TRACE_REPLICATION(i)
+#define TRACE_EVENT(type, q1, q2, s1, s2, transit)
+#define TRACE_CLOSE()
+
+#endif
+
+#endif
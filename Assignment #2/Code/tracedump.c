@@ -0,0 +1,124 @@
+/* Decoder for binary event traces written by mm2_t.c compiled with -DTRACE.
+
+   Usage: tracedump [trace file]   (default mm2_t.trace)
+
+   Writes one line per event to standard output, in the form of the former
+   debugging printf lines of mm2_t.c, preceded by the replication and the
+   simulation time. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"  /* Header file for trace format. */
+
+static const char *event_names[] =
+    { "", "ARRIVE1", "DEPART1", "ARRIVE2", "DEPART2", "FINISH" };
+
+static int get_varint(FILE *infile, int64_t *v);
+static int unpacked(int code);
+
+
+int main(int argc, char *argv[])  /* Main function. */
+{
+    struct trace_header header;
+    struct trace_record r;
+    int                 c, flag, ok;
+    int64_t             v, d1, d2, dt, dbits;
+    uint32_t            bits;
+    FILE                *infile;
+    const char          *path;
+
+    path   = argc > 1 ? argv[1] : "mm2_t.trace";
+    infile = fopen(path, "rb");
+    if (infile == NULL) {
+        fprintf(stderr, "Cannot open trace file %s\n", path);
+        return 1;
+    }
+
+    /* Check the header. */
+
+    if (fread(&header, sizeof(header), 1, infile) != 1 ||
+        header.magic != TRACE_MAGIC || header.version != TRACE_VERSION ||
+        header.record_size != sizeof(struct trace_record)) {
+        fprintf(stderr, "%s is not a version %d mm2_t trace\n", path,
+                TRACE_VERSION);
+        return 1;
+    }
+
+    /* Decode the records, each a change from the one before it (see
+       trace.h), until the end of the file. */
+
+    memset(&r, 0, sizeof(r));
+    while ((flag = getc(infile)) != EOF) {
+
+        /* A flag byte of 0 starts a replication from a zero record. */
+
+        if (flag == 0) {
+            if (!get_varint(infile, &v))
+                break;
+            memset(&r, 0, sizeof(r));
+            r.replication = v;
+            continue;
+        }
+        if (flag & 0x20)
+            ok = get_varint(infile, &d1) && get_varint(infile, &d2) &&
+                 get_varint(infile, &dt);
+        else {
+            ok = (c = getc(infile)) != EOF;
+            d1 = unpacked(c & 3);
+            d2 = unpacked((c >> 2) & 3);
+            dt = unpacked((c >> 4) & 3);
+        }
+        if (!ok || !get_varint(infile, &dbits))
+            break;
+        r.event_type      = flag & 7;
+        r.server_status   = (flag >> 3) & 3;
+        r.num_in_q1      += d1;
+        r.num_in_q2      += d2;
+        r.num_in_transit += dt;
+        memcpy(&bits, &r.sim_time, sizeof(bits));
+        bits += (uint32_t) dbits;
+        memcpy(&r.sim_time, &bits, sizeof(bits));
+
+        printf("%3d %12.4f %s: %d in queue 1 and %d in queue 2, ",
+               r.replication, r.sim_time,
+               r.event_type <= 5 ? event_names[r.event_type] : "?",
+               r.num_in_q1, r.num_in_q2);
+        printf("SERVER 1 STATUS: %d and SERVER 2 STATUS: %d, ",
+               r.server_status & 1, (r.server_status >> 1) & 1);
+        printf("%d in transit\n", r.num_in_transit);
+    }
+    if (flag != EOF)
+        fprintf(stderr, "%s is truncated\n", path);
+
+    fclose(infile);
+    return flag != EOF;
+}
+
+
+static int get_varint(FILE *infile, int64_t *v)  /* Read a zigzag varint
+                                                    into v, and return 1, or
+                                                    0 at the end of the
+                                                    file. */
+{
+    int      c, shift;
+    uint64_t u;
+
+    u = 0;
+    for (shift = 0; shift < 64; shift += 7) {
+        if ((c = getc(infile)) == EOF)
+            return 0;
+        u |= (uint64_t) (c & 0x7f) << shift;
+        if (!(c & 0x80)) {
+            *v = (int64_t) (u >> 1) ^ -(int64_t) (u & 1);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+static int unpacked(int code)  /* Return the change of a 2-bit code. */
+{
+    return code == 1 ? 1 : code == 2 ? -1 : 0;
+}
@@ -0,0 +1,129 @@
+#!/bin/sh
+# Events-per-second benchmark of the simulation models.
+#
+# Usage: sh bench.sh [model ...]
+#
+# Models are mm1, mm1alt and inv (chap1_c), mm2 (Assignment #1) and mm2_t
+# (Assignment #2), mm1cpp and invcpp, the ports of mm1 and inv to the C++
+# engine of chap1_c/sim.hpp, and mm2_tproc, mm2_t written as coroutine
+# processes on Assignment #2/Code/proc.hpp, which read the same inputs; the
+# default is all of them.  Each model is compiled with
+# -DBENCH (see bench.h) for every queue limit in BENCH_QLIMITS and run for
+# every load in BENCH_LOADS and run length in BENCH_LENGTHS.  For the queueing
+# models the load is the utilization rho (service means are rho times the
+# interarrival mean); for inv it scales the demand rate (mean interdemand time
+# 0.01 / rho months).  The run length is the number of customers for mm1, the
+# simulated time for mm1alt, the simulated time summed over the 10
+# replications for mm2 and mm2_t, and ten times the number of months
+# simulated for each of the 9 policies of inv.
+#
+# One CSV row per run is appended to $BENCH_CSV (default bench.csv):
+#   model,load,length,q_limit,status,events,seconds,events_per_sec,
+#   ns_per_event,peak_queue,peak_rss_kb
+# status is "ok", or "overflow" if the queue limit was exceeded.
+
+ROOT=$(cd "$(dirname "$0")" && pwd)
+CSV=${BENCH_CSV:-bench.csv}
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--O2}
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--std=c++17 -O2}
+LOADS=${BENCH_LOADS:-"0.1 0.3 0.5 0.7 0.8 0.9 0.95 0.99"}
+LENGTHS=${BENCH_LENGTHS:-"10000 100000 1000000"}
+QLIMITS=${BENCH_QLIMITS:-"100 10000 1000000"}
+MODELS=${*:-"mm1 mm1alt inv mm2 mm2_t mm1cpp invcpp mm2_tproc"}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if [ ! -f "$CSV" ]; then
+    echo "model,load,length,q_limit,status,events,seconds,events_per_sec,ns_per_event,peak_queue,peak_rss_kb" > "$CSV"
+fi
+
+for model in $MODELS; do
+    case $model in
+        mm1|mm1alt|inv|mm1cpp|invcpp) dir="$ROOT/chap1_c" ;;
+        mm2)            dir="$ROOT/Assignment #1/Code" ;;
+        mm2_t|mm2_tproc) dir="$ROOT/Assignment #2/Code" ;;
+        *) echo "bench.sh: unknown model $model" >&2; exit 1 ;;
+    esac
+
+    # inv has no queue, and the queues of mm2_tproc have no limit, so they are
+    # built once.
+
+    qlimits=$QLIMITS
+    if [ "$model" = inv ] || [ "$model" = invcpp ] ||
+       [ "$model" = mm2_tproc ]; then
+        qlimits=0
+    fi
+
+    # The sources are the model, the modules it uses, and the generator.  The
+    # C++ ports link with the generator compiled as C, and mm2_tproc needs
+    # C++20 for its coroutines.
+
+    base=${model%cpp}
+    if [ "$model" = mm2_tproc ]; then
+        $CC $CFLAGS -c -o "$WORK/lcgrand.o" "$dir/lcgrand.c" || exit 1
+        set -- "$dir/$model.cpp" "$WORK/lcgrand.o"
+        compile="$CXX $CXXFLAGS -std=c++20"
+    elif [ "$base" != "$model" ]; then
+        $CC $CFLAGS -c -o "$WORK/lcgrand.o" "$dir/lcgrand.c" || exit 1
+        set -- "$dir/$base.cpp" "$WORK/lcgrand.o"
+        compile="$CXX $CXXFLAGS"
+    else
+        set -- "$dir/$model.c" "$dir/lcgrand.c"
+        compile="$CC $CFLAGS"
+    fi
+    if [ "$model" = mm2 ] || [ "$model" = mm2_t ]; then
+        set -- "$@" "$dir/dist.c"
+    fi
+
+    for q in $qlimits; do
+        exe="$WORK/$model.$q"
+        if [ "$qlimits" = 0 ]; then
+            $compile -DBENCH -o "$exe" "$@" -lm
+        else
+            $compile -DBENCH -DQ_LIMIT=$q -o "$exe" "$@" -lm
+        fi || exit 1
+
+        for load in $LOADS; do
+            for length in $LENGTHS; do
+                run="$WORK/run"
+                rm -rf "$run"
+                mkdir "$run"
+
+                # Write the model's input file under the name it opens.
+
+                case $model in
+                    mm1|mm1cpp)
+                        echo "1.0 $load $length" > "$run/mm1.in" ;;
+                    mm1alt)
+                        echo "1.0 $load $length" > "$run/mm1alt.in" ;;
+                    inv|invcpp)
+                        mean=$(awk "BEGIN { print 0.01 / $load }")
+                        months=$((length / 10))
+                        printf '60 %d 9 4\n%s 32.0 3.0 1.0 5.0 0.5 1.0\n' \
+                            $months $mean > "$run/inv.in"
+                        printf '0.167 0.500 0.833 1.0\n' >> "$run/inv.in"
+                        printf '20 40\n20 60\n20 80\n20 100\n40 60\n40 80\n' \
+                            >> "$run/inv.in"
+                        printf '40 100\n60 80\n60 100\n' >> "$run/inv.in" ;;
+                    mm2)
+                        echo "1.0 $load $load $((length / 10))" > "$run/mm2.in1" ;;
+                    mm2_t|mm2_tproc)
+                        echo "1.0 $load $load $((length / 10))" > "$run/mm2_t.in" ;;
+                esac
+
+                line=$(cd "$run" && "$exe" 2>&1 >/dev/null)
+                status=$?
+                if [ $status -eq 0 ]; then
+                    echo "$model,$load,$length,$q,ok,$line" >> "$CSV"
+                elif [ $status -eq 2 ]; then
+                    echo "$model,$load,$length,$q,overflow,,,,,," >> "$CSV"
+                else
+                    echo "$model,$load,$length,$q,error$status,,,,,," >> "$CSV"
+                fi
+                echo "$model load=$load length=$length q_limit=$q: ${line:-status $status}"
+            done
+        done
+    done
+done
@@ -3,6 +3,9 @@
 #include <stdio.h>
 #include <math.h>
 #include "lcgrand.h"  /* Header file for random-number generator. */
+#include "bench.h"    /* Header file for benchmark hooks. */
+#include "instr.h"    /* Header file for instrumentation hooks. */
+#include "results.h"  /* Header file for machine-readable results. */
 
 int   amount, bigs, initial_inv_level, inv_level, next_event_type, num_events,
       num_months, num_values_demand, smalls;
@@ -32,6 +35,7 @@ int main()  /* Main function. */
 
     infile  = fopen("inv.in",  "r");
     outfile = fopen("inv.out", "w");
+    RESULTS_OPEN("inv", 1);
 
     /* Specify the number of events for the timing function. */
 
@@ -69,11 +73,19 @@ int main()  /* Main function. */
 
     /* Run the simulation varying the inventory policy. */
 
+    BENCH_START();
     for (i = 1; i <= num_policies; ++i) {
 
         /* Read the inventory policy, and initialize the simulation. */
 
         fscanf(infile, "%d %d", &smalls, &bigs);
+
+        /* Each policy is simulated once, so its row is replication 0, and
+           the policy number (from 1, in input order) is a column of its
+           own. */
+
+        RESULTS_START(0);
+        RESULTS_INT("policy", i);
         initialize();
 
         /* Run the simulation until it terminates after an end-simulation event
@@ -83,27 +95,37 @@ int main()  /* Main function. */
 
             /* Determine the next event. */
 
+            INSTR_BEGIN(INSTR_TIMING);
             timing();
+            INSTR_END(INSTR_TIMING);
+            BENCH_EVENT();
 
             /* Update time-average statistical accumulators. */
 
+            INSTR_BEGIN(INSTR_STATS);
             update_time_avg_stats();
-
-            /* Invoke the appropriate event function. */
-
-            switch (next_event_type) {
-                case 1:
-                    order_arrival();
-                    break;
-                case 2:
-                    demand();
-                    break;
-                case 4:
-                    evaluate();
-                    break;
-                case 3:
-                    report();
-                    break;
+            INSTR_END(INSTR_STATS);
+
+            /* Invoke the appropriate event function.  The end-simulation
+               event is not timed, since report() writes the instrumentation
+               figures and resets them for the next policy. */
+
+            if (next_event_type == 3)
+                report();
+            else {
+                INSTR_BEGIN(INSTR_EVENT(next_event_type));
+                switch (next_event_type) {
+                    case 1:
+                        order_arrival();
+                        break;
+                    case 2:
+                        demand();
+                        break;
+                    case 4:
+                        evaluate();
+                        break;
+                }
+                INSTR_END(INSTR_EVENT(next_event_type));
             }
 
         /* If the event just executed was not the end-simulation event (type 3),
@@ -115,6 +137,8 @@ int main()  /* Main function. */
 
     /* End the simulations. */
 
+    BENCH_STOP();
+    RESULTS_CLOSE();
     fclose(infile);
     fclose(outfile);
     return 0;
@@ -241,6 +265,27 @@ void report(void)  /* Report generator function. */
             smalls, bigs,
             avg_ordering_cost + avg_holding_cost + avg_shortage_cost,
             avg_ordering_cost, avg_holding_cost, avg_shortage_cost);
+    INSTR_REPORT(outfile);
+
+    /* Write the parameters and measures as a machine-readable row. */
+
+    RESULTS_INT("initial_inv_level", initial_inv_level);
+    RESULTS_INT("num_months", num_months);
+    RESULTS_REAL("mean_interdemand", mean_interdemand);
+    RESULTS_REAL("setup_cost", setup_cost);
+    RESULTS_REAL("incremental_cost", incremental_cost);
+    RESULTS_REAL("holding_cost", holding_cost);
+    RESULTS_REAL("shortage_cost", shortage_cost);
+    RESULTS_REAL("minlag", minlag);
+    RESULTS_REAL("maxlag", maxlag);
+    RESULTS_INT("smalls", smalls);
+    RESULTS_INT("bigs", bigs);
+    RESULTS_REAL("avg_total_cost",
+                 avg_ordering_cost + avg_holding_cost + avg_shortage_cost);
+    RESULTS_REAL("avg_ordering_cost", avg_ordering_cost);
+    RESULTS_REAL("avg_holding_cost", avg_holding_cost);
+    RESULTS_REAL("avg_shortage_cost", avg_shortage_cost);
+    RESULTS_ROW();
 }
 
 
@@ -268,9 +313,14 @@ void update_time_avg_stats(void)  /* Update area accumulators for time-average
 
 float expon(float mean)  /* Exponential variate generation function. */
 {
+    float x;
+
     /* Return an exponential random variate with mean "mean". */
 
-    return -mean * log(lcgrand(1));
+    INSTR_RNG_BEGIN();
+    x = -mean * log(lcgrand(1));
+    INSTR_RNG_END(1);
+    return x;
 }
 
 
@@ -282,7 +332,9 @@ int random_integer(float prob_distrib[])  /* Random integer generation
 
     /* Generate a U(0,1) random variate. */
 
+    INSTR_RNG_BEGIN();
     u = lcgrand(1);
+    INSTR_RNG_END(1);
 
     /* Return a random integer in accordance with the (cumulative) distribution
        function prob_distrib. */
@@ -295,8 +347,13 @@ int random_integer(float prob_distrib[])  /* Random integer generation
 
 float uniform(float a, float b)  /* Uniform variate generation function. */
 {
+    float x;
+
     /* Return a U(a,b) random variate. */
 
-    return a + lcgrand(1) * (b - a);
+    INSTR_RNG_BEGIN();
+    x = a + lcgrand(1) * (b - a);
+    INSTR_RNG_END(1);
+    return x;
 }
 
@@ -0,0 +1,201 @@
+/* Inventory system on the compile-time engine of sim.hpp.  It reads inv.in
+   and writes the report of inv.c to invcpp.out. */
+
+#include <cmath>
+#include <cstdio>
+#include "sim.hpp"    /* Header file for the simulation engine. */
+extern "C" {
+#include "lcgrand.h"  /* Header file for random-number generator. */
+}
+
+struct order_arrival {};  /* Event types, in the order of inv.c. */
+struct demand {};
+struct end_simulation {};
+struct evaluate {};
+
+struct inv : sim::engine<inv, order_arrival, demand, end_simulation,
+                         evaluate> {
+    int   amount, bigs, initial_inv_level, inv_level, num_months,
+          num_values_demand, smalls;
+    float area_holding, area_shortage, holding_cost, incremental_cost, maxlag,
+          mean_interdemand, minlag, prob_distrib_demand[26], setup_cost,
+          shortage_cost, total_ordering_cost;
+    FILE  *outfile;
+
+    void initialize()  /* Initialization function. */
+    {
+        /* Initialize the simulation clock, the state variables and the
+           statistical counters. */
+
+        start();
+        inv_level           = initial_inv_level;
+        total_ordering_cost = 0.0;
+        area_holding        = 0.0;
+        area_shortage       = 0.0;
+
+        /* Initialize the event list.  Since no order is outstanding, the
+           order-arrival event is eliminated from consideration. */
+
+        cancel<order_arrival>();
+        schedule<demand>(sim_time + expon(mean_interdemand));
+        schedule<end_simulation>(num_months);
+        schedule<evaluate>(0.0);
+    }
+
+    void handle(order_arrival)  /* Order arrival event function. */
+    {
+        /* Increment the inventory level by the amount ordered.  Since no
+           order is now outstanding, eliminate the order-arrival event from
+           consideration. */
+
+        inv_level += amount;
+        cancel<order_arrival>();
+    }
+
+    void handle(demand)  /* Demand event function. */
+    {
+        /* Decrement the inventory level by a generated demand size, and
+           schedule the time of the next demand. */
+
+        inv_level -= random_integer(prob_distrib_demand);
+        schedule<demand>(sim_time + expon(mean_interdemand));
+    }
+
+    void handle(evaluate)  /* Inventory-evaluation event function. */
+    {
+        /* Check whether the inventory level is less than smalls. */
+
+        if (inv_level < smalls) {
+
+            /* The inventory level is less than smalls, so place an order for
+               the appropriate amount, and schedule its arrival. */
+
+            amount               = bigs - inv_level;
+            total_ordering_cost += setup_cost + incremental_cost * amount;
+            schedule<order_arrival>(sim_time + uniform(minlag, maxlag));
+        }
+
+        /* Regardless of the place-order decision, schedule the next inventory
+           evaluation. */
+
+        schedule<evaluate>(sim_time + 1.0f);
+    }
+
+    void handle(end_simulation)  /* Report generator function. */
+    {
+        float avg_holding_cost, avg_ordering_cost, avg_shortage_cost;
+
+        /* Compute and write estimates of desired measures of performance. */
+
+        avg_ordering_cost = total_ordering_cost / num_months;
+        avg_holding_cost  = holding_cost * area_holding / num_months;
+        avg_shortage_cost = shortage_cost * area_shortage / num_months;
+        std::fprintf(outfile, "\n\n(%3d,%3d)%15.2f%15.2f%15.2f%15.2f",
+                     smalls, bigs,
+                     avg_ordering_cost + avg_holding_cost + avg_shortage_cost,
+                     avg_ordering_cost, avg_holding_cost, avg_shortage_cost);
+    }
+
+    void update_time_avg_stats(float time_since_last_event)  /* Update area
+                                   accumulators for time-average statistics. */
+    {
+        /* If the inventory level during the previous interval was negative,
+           update area_shortage.  If it was positive, update area_holding. */
+
+        if (inv_level < 0)
+            area_shortage -= inv_level * time_since_last_event;
+        else if (inv_level > 0)
+            area_holding  += inv_level * time_since_last_event;
+    }
+
+    static float expon(float mean)  /* Exponential variate generation
+                                       function. */
+    {
+        return -mean * std::log(static_cast<double>(lcgrand(1)));
+    }
+
+    static int random_integer(const float prob_distrib[])  /* Random integer
+                                                        generation function. */
+    {
+        int   i;
+        float u;
+
+        /* Return a random integer in accordance with the (cumulative)
+           distribution function prob_distrib. */
+
+        u = lcgrand(1);
+        for (i = 1; u >= prob_distrib[i]; ++i)
+            ;
+        return i;
+    }
+
+    static float uniform(float a, float b)  /* Uniform variate generation
+                                               function. */
+    {
+        return a + lcgrand(1) * (b - a);
+    }
+};
+
+static inv model;
+
+
+int main()  /* Main function. */
+{
+    int  i, num_policies;
+    FILE *infile, *outfile;
+
+    /* Open input and output files, and read input parameters. */
+
+    infile  = std::fopen("inv.in",  "r");
+    outfile = std::fopen("invcpp.out", "w");
+    model.outfile = outfile;
+    std::fscanf(infile, "%d %d %d %d %f %f %f %f %f %f %f",
+                &model.initial_inv_level, &model.num_months, &num_policies,
+                &model.num_values_demand, &model.mean_interdemand,
+                &model.setup_cost, &model.incremental_cost,
+                &model.holding_cost, &model.shortage_cost, &model.minlag,
+                &model.maxlag);
+    for (i = 1; i <= model.num_values_demand; ++i)
+        std::fscanf(infile, "%f", &model.prob_distrib_demand[i]);
+
+    /* Write report heading and input parameters. */
+
+    std::fprintf(outfile, "Single-product inventory system\n\n");
+    std::fprintf(outfile, "Initial inventory level%24d items\n\n",
+                 model.initial_inv_level);
+    std::fprintf(outfile, "Number of demand sizes%25d\n\n",
+                 model.num_values_demand);
+    std::fprintf(outfile, "Distribution function of demand sizes  ");
+    for (i = 1; i <= model.num_values_demand; ++i)
+        std::fprintf(outfile, "%8.3f", model.prob_distrib_demand[i]);
+    std::fprintf(outfile, "\n\nMean interdemand time%26.2f\n\n",
+                 model.mean_interdemand);
+    std::fprintf(outfile, "Delivery lag range%29.2f to%10.2f months\n\n",
+                 model.minlag, model.maxlag);
+    std::fprintf(outfile, "Length of the simulation%23d months\n\n",
+                 model.num_months);
+    std::fprintf(outfile, "K =%6.1f   i =%6.1f   h =%6.1f   pi =%6.1f\n\n",
+                 model.setup_cost, model.incremental_cost, model.holding_cost,
+                 model.shortage_cost);
+    std::fprintf(outfile, "Number of policies%29d\n\n", num_policies);
+    std::fprintf(outfile, "                 Average        Average");
+    std::fprintf(outfile, "        Average        Average\n");
+    std::fprintf(outfile, "  Policy       total cost    ordering cost");
+    std::fprintf(outfile, "  holding cost   shortage cost");
+
+    /* Run the simulation varying the inventory policy, each until the
+       end-simulation event has been executed. */
+
+    BENCH_START();
+    for (i = 1; i <= num_policies; ++i) {
+        std::fscanf(infile, "%d %d", &model.smalls, &model.bigs);
+        model.initialize();
+        while (model.step() != inv::index<end_simulation>)
+            ;
+    }
+    BENCH_STOP();
+
+    std::fclose(infile);
+    std::fclose(outfile);
+    return 0;
+}
@@ -0,0 +1,97 @@
+/* External definitions for inventory system, all policies simulated in a single
+   pass over common random numbers. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "invpass.h"  /* Header file for single-pass multi-policy simulation. */
+
+struct inv_params   par;
+struct inv_policies pol;
+FILE  *infile, *outfile;
+
+void  report(void);
+
+
+int main()  /* Main function. */
+{
+    int  i, num_policies;
+    long zrng[4];
+
+    /* Open input and output files. */
+
+    infile  = fopen("invcrn.in",  "r");
+    outfile = fopen("invcrn.out", "w");
+
+    /* Read input parameters and the policies to be evaluated, either listed as
+       in inv.in or, if the number of policies is 0, as a grid. */
+
+    num_policies = inv_read_params(infile, &par);
+    if (inv_read_policies(infile, &pol, num_policies) == 0) {
+        fprintf(outfile, "\nNo policies to evaluate");
+        exit(1);
+    }
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Single-product inventory system, single pass over");
+    fprintf(outfile, " common random numbers\n\n");
+    fprintf(outfile, "Initial inventory level%24d items\n\n",
+            par.initial_inv_level);
+    fprintf(outfile, "Number of demand sizes%25d\n\n", par.num_values_demand);
+    fprintf(outfile, "Distribution function of demand sizes  ");
+    for (i = 1; i <= par.num_values_demand; ++i)
+        fprintf(outfile, "%8.3f", par.prob_distrib_demand[i]);
+    fprintf(outfile, "\n\nMean interdemand time%26.2f\n\n",
+            par.mean_interdemand);
+    fprintf(outfile, "Delivery lag range%29.2f to%10.2f months\n\n",
+            par.minlag, par.maxlag);
+    fprintf(outfile, "Length of the simulation%23d months\n\n",
+            par.num_months);
+    fprintf(outfile, "K =%6.1f   i =%6.1f   h =%6.1f   pi =%6.1f\n\n",
+            par.setup_cost, par.incremental_cost, par.holding_cost,
+            par.shortage_cost);
+    fprintf(outfile, "Number of policies%29d\n\n", pol.num_policies);
+    fprintf(outfile, "                 Average        Average");
+    fprintf(outfile, "        Average        Average\n");
+    fprintf(outfile, "  Policy       total cost    ordering cost");
+    fprintf(outfile, "  holding cost   shortage cost");
+
+    /* Generate one demand trajectory and advance every policy against it. */
+
+    zrng[STREAM_INTERDEMAND] = lcgrandgt(STREAM_INTERDEMAND);
+    zrng[STREAM_DEMAND_SIZE] = lcgrandgt(STREAM_DEMAND_SIZE);
+    zrng[STREAM_LAG]         = lcgrandgt(STREAM_LAG);
+    inv_pass(&par, &pol, zrng);
+
+    /* Invoke the report generator and end the simulation. */
+
+    report();
+
+    inv_free_policies(&pol);
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    int   i;
+    float avg_holding_cost, avg_ordering_cost, avg_shortage_cost;
+
+    /* Compute and write estimates of desired measures of performance for every
+       policy. */
+
+    for (i = 0; i < pol.num_policies; ++i) {
+        avg_ordering_cost = pol.total_ordering_cost[i] / par.num_months;
+        avg_holding_cost  = par.holding_cost * pol.area_holding[i] /
+                            par.num_months;
+        avg_shortage_cost = par.shortage_cost * pol.area_shortage[i] /
+                            par.num_months;
+        fprintf(outfile, "\n\n(%3d,%3d)%15.2f%15.2f%15.2f%15.2f",
+                pol.smalls[i], pol.bigs[i],
+                avg_ordering_cost + avg_holding_cost + avg_shortage_cost,
+                avg_ordering_cost, avg_holding_cost, avg_shortage_cost);
+    }
+}
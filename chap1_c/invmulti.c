@@ -0,0 +1,358 @@
+/* External definitions for multi-item inventory system with a shared review
+   period. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdint.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+#define CLASS_LIMIT 100         /* Limit on number of demand classes. */
+#define MODLUS      2147483647  /* Modulus of lcgrand. */
+
+int   num_classes, num_items, num_months, num_values_demand[CLASS_LIMIT + 1];
+float holding_cost, incremental_cost, maxlag, mean_interdemand[CLASS_LIMIT + 1],
+      minlag, prob_distrib_demand[CLASS_LIMIT + 1][26], setup_cost,
+      shortage_cost;
+
+/* Per-item state, statistical counters, random-number streams and counts of
+   random numbers drawn, each in a contiguous array indexed by item. */
+
+int   *item_class, *smalls, *bigs, *inv_level, *amount;
+char  *ordered;
+float *time_next_demand, *time_order_arrival, *area_holding, *area_shortage,
+      *total_ordering_cost;
+long  *zrng, *randoms;
+FILE  *infile, *outfile;
+
+void  read_items(int num_item_lines);
+void  initialize(void);
+void  evaluate(int month);
+void  demands(int month);
+void  report(void);
+void  update_time_avg_stats(int i, float time_last_event, float time_event);
+float expon(float mean, int item);
+int   random_integer(float prob_distrib [], int item);
+float uniform(float a, float b, int item);
+
+
+int main()  /* Main function. */
+{
+    int i, j, month, num_item_lines;
+
+    /* Open input and output files. */
+
+    infile  = fopen("invmulti.in",  "r");
+    outfile = fopen("invmulti.out", "w");
+
+    /* Read input parameters: the run length and costs shared by all items,
+       the demand classes (mean interdemand time and distribution function of
+       demand sizes), and the item lines. */
+
+    fscanf(infile, "%d %d %d", &num_months, &num_classes, &num_item_lines);
+    fscanf(infile, "%f %f %f %f %f %f", &setup_cost, &incremental_cost,
+           &holding_cost, &shortage_cost, &minlag, &maxlag);
+    if (num_classes > CLASS_LIMIT) {
+        fprintf(outfile, "\nToo many demand classes");
+        exit(1);
+    }
+    for (i = 1; i <= num_classes; ++i) {
+        fscanf(infile, "%f %d", &mean_interdemand[i], &num_values_demand[i]);
+        for (j = 1; j <= num_values_demand[i]; ++j)
+            fscanf(infile, "%f", &prob_distrib_demand[i][j]);
+    }
+    read_items(num_item_lines);
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Multi-item inventory system\n\n");
+    fprintf(outfile, "Number of items%32d\n\n", num_items);
+    fprintf(outfile, "Number of demand classes%23d\n\n", num_classes);
+    fprintf(outfile, "  Class  Mean interdemand time  Distribution function");
+    fprintf(outfile, " of demand sizes\n");
+    for (i = 1; i <= num_classes; ++i) {
+        fprintf(outfile, "\n%7d%23.2f  ", i, mean_interdemand[i]);
+        for (j = 1; j <= num_values_demand[i]; ++j)
+            fprintf(outfile, "%8.3f", prob_distrib_demand[i][j]);
+    }
+    fprintf(outfile, "\n\nDelivery lag range%29.2f to%10.2f months\n\n",
+            minlag, maxlag);
+    fprintf(outfile, "Length of the simulation%23d months\n\n", num_months);
+    fprintf(outfile, "K =%6.1f   i =%6.1f   h =%6.1f   pi =%6.1f\n\n",
+            setup_cost, incremental_cost, holding_cost, shortage_cost);
+
+    /* Initialize the simulation. */
+
+    initialize();
+
+    /* Run the simulation month by month.  The inventory evaluations of all
+       items happen together at the start of each month, and each item's own
+       demands and order arrival during the month are then processed in time
+       order without a shared event list. */
+
+    for (month = 0; month < num_months; ++month) {
+        evaluate(month);
+        demands(month);
+    }
+
+    /* Invoke the report generator and end the simulation. */
+
+    report();
+
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+void read_items(int num_item_lines)  /* Item input function. */
+{
+    int  i, j, k, count, class, s, bigs_in, level;
+    long pos;
+
+    /* Each item line "count class s S initial_inv_level" describes count items
+       with the same demand class, policy and initial inventory level.  Count
+       the items first, so that the per-item arrays can be allocated once. */
+
+    pos       = ftell(infile);
+    num_items = 0;
+    for (k = 1; k <= num_item_lines; ++k) {
+        fscanf(infile, "%d %d %d %d %d", &count, &class, &s, &bigs_in, &level);
+        num_items += count;
+    }
+    fseek(infile, pos, SEEK_SET);
+
+    item_class          = malloc(num_items * sizeof(int));
+    smalls              = malloc(num_items * sizeof(int));
+    bigs                = malloc(num_items * sizeof(int));
+    inv_level           = malloc(num_items * sizeof(int));
+    amount              = malloc(num_items * sizeof(int));
+    ordered             = malloc(num_items * sizeof(char));
+    time_next_demand    = malloc(num_items * sizeof(float));
+    time_order_arrival  = malloc(num_items * sizeof(float));
+    area_holding        = malloc(num_items * sizeof(float));
+    area_shortage       = malloc(num_items * sizeof(float));
+    total_ordering_cost = malloc(num_items * sizeof(float));
+    zrng                = malloc(num_items * sizeof(long));
+    randoms             = malloc(num_items * sizeof(long));
+
+    i = 0;
+    for (k = 1; k <= num_item_lines; ++k) {
+        fscanf(infile, "%d %d %d %d %d", &count, &class, &s, &bigs_in, &level);
+        if (class < 1 || class > num_classes) {
+            fprintf(outfile, "\nItem line %d has unknown demand class %d", k,
+                    class);
+            exit(1);
+        }
+        for (j = 0; j < count; ++j, ++i) {
+            item_class[i] = class;
+            smalls[i]     = s;
+            bigs[i]       = bigs_in;
+            inv_level[i]  = level;
+        }
+    }
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    int  i;
+    long spacing, step;
+
+    /* Give each item its own random-number stream: the items' seeds split the
+       cycle of lcgrand after the seed of stream 1 into equal, disjoint
+       segments, item i starting i * spacing steps after item 0. */
+
+    spacing = (MODLUS - 1) / num_items;
+    step    = lcgrandjp(1, spacing);
+    for (i = 0; i < num_items; ++i) {
+        zrng[i] = i == 0 ? lcgrandgt(1) :
+                           (long) ((int64_t) zrng[i - 1] * step % MODLUS);
+
+        /* Initialize the state variables and statistical counters.  No order
+           is outstanding, and the first demand is scheduled. */
+
+        amount[i]              = 0;
+        time_order_arrival[i]  = 1.0e+30;
+        area_holding[i]        = 0.0;
+        area_shortage[i]       = 0.0;
+        total_ordering_cost[i] = 0.0;
+        randoms[i]             = 0;
+        time_next_demand[i]    = expon(mean_interdemand[item_class[i]], i);
+    }
+}
+
+
+void evaluate(int month)  /* Inventory-evaluation function, for all items at
+                             the start of month "month". */
+{
+    int i, size;
+
+    /* Decide for every item whether its inventory level is below smalls, and
+       if so place an order for the appropriate amount.  This sweep has no
+       branches, so it can be vectorized over items. */
+
+    for (i = 0; i < num_items; ++i) {
+        ordered[i] = inv_level[i] < smalls[i];
+        size       = bigs[i] - inv_level[i];
+
+        amount[i]               = ordered[i] ? size : amount[i];
+        total_ordering_cost[i] += ordered[i] ? setup_cost +
+                                  incremental_cost * size : 0.0;
+    }
+
+    /* Schedule the arrival of each order placed. */
+
+    for (i = 0; i < num_items; ++i)
+        if (ordered[i])
+            time_order_arrival[i] = month + uniform(minlag, maxlag, i);
+}
+
+
+void demands(int month)  /* Demand and order-arrival function, for all items
+                            during month "month". */
+{
+    int   i, class;
+    float time_last_event, time_end;
+
+    time_end = month + 1;
+    for (i = 0; i < num_items; ++i) {
+        class           = item_class[i];
+        time_last_event = month;
+
+        /* Process the item's demands during the month, each preceded by the
+           order arrival if it comes first. */
+
+        while (time_next_demand[i] < time_end) {
+            if (time_order_arrival[i] <= time_next_demand[i]) {
+                update_time_avg_stats(i, time_last_event,
+                                      time_order_arrival[i]);
+                time_last_event       = time_order_arrival[i];
+                inv_level[i]         += amount[i];
+                time_order_arrival[i] = 1.0e+30;
+            }
+            update_time_avg_stats(i, time_last_event, time_next_demand[i]);
+            time_last_event      = time_next_demand[i];
+            inv_level[i]        -= random_integer(prob_distrib_demand[class],
+                                                  i);
+            time_next_demand[i] += expon(mean_interdemand[class], i);
+        }
+
+        /* Process an order arriving after the last demand of the month, and
+           update the area accumulators to the end of the month. */
+
+        if (time_order_arrival[i] < time_end) {
+            update_time_avg_stats(i, time_last_event, time_order_arrival[i]);
+            time_last_event       = time_order_arrival[i];
+            inv_level[i]         += amount[i];
+            time_order_arrival[i] = 1.0e+30;
+        }
+        update_time_avg_stats(i, time_last_event, time_end);
+    }
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    int    i;
+    long   randoms_max;
+    float  avg_holding_cost, avg_ordering_cost, avg_shortage_cost;
+    double sum_holding, sum_ordering, sum_shortage;
+
+    /* Compute and write estimates of desired measures of performance for each
+       item, and accumulate catalog totals. */
+
+    fprintf(outfile, "Random numbers per item stream%17ld\n\n",
+            (long) ((MODLUS - 1) / num_items));
+    fprintf(outfile, "                                 Average        Average");
+    fprintf(outfile, "        Average        Average\n");
+    fprintf(outfile, "    Item  Class     Policy    total cost   ordering cost");
+    fprintf(outfile, "  holding cost  shortage cost");
+
+    sum_holding = sum_ordering = sum_shortage = 0.0;
+    for (i = 0; i < num_items; ++i) {
+        avg_ordering_cost = total_ordering_cost[i] / num_months;
+        avg_holding_cost  = holding_cost * area_holding[i] / num_months;
+        avg_shortage_cost = shortage_cost * area_shortage[i] / num_months;
+        sum_ordering     += avg_ordering_cost;
+        sum_holding      += avg_holding_cost;
+        sum_shortage     += avg_shortage_cost;
+        fprintf(outfile, "\n\n%8d%7d  (%3d,%3d)%14.2f%15.2f%15.2f%15.2f",
+                i + 1, item_class[i], smalls[i], bigs[i],
+                avg_ordering_cost + avg_holding_cost + avg_shortage_cost,
+                avg_ordering_cost, avg_holding_cost, avg_shortage_cost);
+    }
+    fprintf(outfile, "\n\n   Total%30.2f%15.2f%15.2f%15.2f",
+            sum_ordering + sum_holding + sum_shortage, sum_ordering,
+            sum_holding, sum_shortage);
+
+    /* Warn if an item ran past its segment into the next item's stream. */
+
+    randoms_max = 0;
+    for (i = 0; i < num_items; ++i)
+        if (randoms[i] > randoms_max)
+            randoms_max = randoms[i];
+    if (randoms_max > (MODLUS - 1) / num_items)
+        fprintf(outfile, "\n\nWarning: an item used %ld random numbers, more"
+                " than its segment of %ld\n", randoms_max,
+                (long) ((MODLUS - 1) / num_items));
+}
+
+
+void update_time_avg_stats(int i, float time_last_event, float time_event)
+    /* Update area accumulators of item i for time-average statistics. */
+{
+    float time_since_last_event;
+
+    time_since_last_event = time_event - time_last_event;
+
+    /* If the inventory level during the previous interval was negative, update
+       area_shortage.  If it was positive, update area_holding.  If it was zero,
+       no update is needed. */
+
+    if (inv_level[i] < 0)
+        area_shortage[i] -= inv_level[i] * time_since_last_event;
+    else if (inv_level[i] > 0)
+        area_holding[i]  += inv_level[i] * time_since_last_event;
+}
+
+
+float expon(float mean, int item)  /* Exponential variate generation
+                                      function, from item's stream. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    ++randoms[item];
+    return -mean * log(lcgrandz(&zrng[item]));
+}
+
+
+int random_integer(float prob_distrib[], int item)  /* Random integer
+                                                       generation function,
+                                                       from item's stream. */
+{
+    int   i;
+    float u;
+
+    /* Generate a U(0,1) random variate. */
+
+    ++randoms[item];
+    u = lcgrandz(&zrng[item]);
+
+    /* Return a random integer in accordance with the (cumulative) distribution
+       function prob_distrib. */
+
+    for (i = 1; u >= prob_distrib[i]; ++i)
+        ;
+    return i;
+}
+
+
+float uniform(float a, float b, int item)  /* Uniform variate generation
+                                              function, from item's stream. */
+{
+    /* Return a U(a,b) random variate. */
+
+    ++randoms[item];
+    return a + lcgrandz(&zrng[item]) * (b - a);
+}
@@ -0,0 +1,327 @@
+/* External definitions for inventory system, search for the cost-minimizing
+   (s,S) policy by racing with early elimination, using the fully sequential
+   procedure of Kim and Nelson (2001). */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "invpass.h"  /* Header file for single-pass multi-policy simulation. */
+
+struct inv_params   par;
+struct inv_policies pol;
+int   best, max_reps, min_reps, num_candidates, num_reps, num_survivors;
+int   *id, *smalls_all, *bigs_all;
+float alpha, delta, *cost, *sum_holding, *sum_ordering, *sum_shortage;
+double eta, h2, policy_reps, *means;
+FILE  *infile, *outfile;
+
+void   screen(void);
+void   compact(void);
+void   report(void);
+double mean_cost(int i);
+int    worse(int i, int l);
+double pair_variance(int i, int l);
+
+
+int main()  /* Main function. */
+{
+    int  i, num_policies;
+    long zrng[4];
+
+    /* Open input and output files. */
+
+    infile  = fopen("invopt.in",  "r");
+    outfile = fopen("invopt.out", "w");
+
+    /* Read input parameters, the candidate policies (listed as in inv.in or,
+       if the number of policies is 0, as a grid), and the racing parameters:
+       initial and maximum replications per policy, the error probability and
+       the indifference-zone width in cost per month. */
+
+    num_policies = inv_read_params(infile, &par);
+    num_candidates = inv_read_policies(infile, &pol, num_policies);
+    fscanf(infile, "%d %d %f %f", &min_reps, &max_reps, &alpha, &delta);
+    if (num_candidates < 2 || min_reps < 2 || max_reps < min_reps) {
+        fprintf(outfile, "\nNeed at least 2 policies and 2 <= n0 <= n_max");
+        exit(1);
+    }
+    if (alpha <= 0.0 || alpha >= 1.0 || delta <= 0.0) {
+        fprintf(outfile, "\nNeed 0 < alpha < 1 and an indifference zone > 0");
+        exit(1);
+    }
+
+    /* Allocate the cost history of every candidate for up to max_reps
+       replications (needed for the variances of paired differences), and
+       remember each survivor's original index. */
+
+    id           = malloc(num_candidates * sizeof(int));
+    smalls_all   = malloc(num_candidates * sizeof(int));
+    bigs_all     = malloc(num_candidates * sizeof(int));
+    cost         = malloc((size_t) num_candidates * max_reps * sizeof(float));
+    sum_ordering = calloc(num_candidates, sizeof(float));
+    sum_holding  = calloc(num_candidates, sizeof(float));
+    sum_shortage = calloc(num_candidates, sizeof(float));
+    means        = malloc(num_candidates * sizeof(double));
+    for (i = 0; i < num_candidates; ++i) {
+        id[i]         = i;
+        smalls_all[i] = pol.smalls[i];
+        bigs_all[i]   = pol.bigs[i];
+    }
+    num_survivors = num_candidates;
+
+    /* Constants of the Kim-Nelson procedure (with c = 1), which bound the
+       probability of eliminating the best policy over all the looks taken
+       from n0 replications on, given normal costs and a best policy better
+       than the others by at least the indifference zone.  The variances of
+       the paired differences are estimated from the first n0 replications,
+       so eta comes from the t distribution with n0 - 1 degrees of freedom
+       rather than from the normal. */
+
+    eta = 0.5 * (pow(2.0 * alpha / (num_candidates - 1),
+                     -2.0 / (min_reps - 1)) - 1.0);
+    h2  = 2.0 * eta * (min_reps - 1);
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Single-product inventory system, policy search by");
+    fprintf(outfile, " racing\n\n");
+    fprintf(outfile, "Initial inventory level%24d items\n\n",
+            par.initial_inv_level);
+    fprintf(outfile, "Number of demand sizes%25d\n\n", par.num_values_demand);
+    fprintf(outfile, "Distribution function of demand sizes  ");
+    for (i = 1; i <= par.num_values_demand; ++i)
+        fprintf(outfile, "%8.3f", par.prob_distrib_demand[i]);
+    fprintf(outfile, "\n\nMean interdemand time%26.2f\n\n",
+            par.mean_interdemand);
+    fprintf(outfile, "Delivery lag range%29.2f to%10.2f months\n\n",
+            par.minlag, par.maxlag);
+    fprintf(outfile, "Length of the simulation%23d months\n\n",
+            par.num_months);
+    fprintf(outfile, "K =%6.1f   i =%6.1f   h =%6.1f   pi =%6.1f\n\n",
+            par.setup_cost, par.incremental_cost, par.holding_cost,
+            par.shortage_cost);
+    fprintf(outfile, "Number of candidate policies%19d\n\n", num_candidates);
+    fprintf(outfile, "Replications per policy%18d to%5d\n\n", min_reps,
+            max_reps);
+    fprintf(outfile, "Error probability%30.3f\n\n", alpha);
+    fprintf(outfile, "Indifference zone%30.2f\n\n", delta);
+    fprintf(outfile, "Kim-Nelson eta%33.3f\n\n", eta);
+    fprintf(outfile, "              Surviving         Best      Average\n");
+    fprintf(outfile, "  Replications  policies       policy   total cost\n");
+
+    /* Race the candidates.  Each replication is one pass of all survivors over
+       a common demand trajectory, so comparisons between policies are paired.
+       After the first min_reps replications, screen after each replication and
+       drop the policies that are clearly worse than another survivor. */
+
+    zrng[STREAM_INTERDEMAND] = lcgrandgt(STREAM_INTERDEMAND);
+    zrng[STREAM_DEMAND_SIZE] = lcgrandgt(STREAM_DEMAND_SIZE);
+    zrng[STREAM_LAG]         = lcgrandgt(STREAM_LAG);
+    policy_reps = 0.0;
+    for (num_reps = 1; num_reps <= max_reps; ++num_reps) {
+        inv_pass(&par, &pol, zrng);
+        policy_reps += num_survivors;
+        for (i = 0; i < num_survivors; ++i) {
+            cost[(size_t) id[i] * max_reps + num_reps - 1] =
+                inv_total_cost(&par, &pol, i);
+            sum_ordering[id[i]] += pol.total_ordering_cost[i] /
+                                   par.num_months;
+            sum_holding[id[i]]  += par.holding_cost * pol.area_holding[i] /
+                                   par.num_months;
+            sum_shortage[id[i]] += par.shortage_cost * pol.area_shortage[i] /
+                                   par.num_months;
+        }
+        if (num_reps < min_reps)
+            continue;
+        screen();
+        if (num_survivors == 1)
+            break;
+    }
+    if (num_reps > max_reps)
+        num_reps = max_reps;
+
+    /* Invoke the report generator and end the search. */
+
+    report();
+
+    inv_free_policies(&pol);
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+void screen(void)  /* Screening function. */
+{
+    int    i, l, before;
+
+    /* Find the average cost of every survivor so far, and the survivor with
+       the smallest. */
+
+    best = 0;
+    for (i = 0; i < num_survivors; ++i) {
+        means[i] = mean_cost(i);
+        if (means[i] < means[best])
+            best = i;
+    }
+
+    /* Eliminate every survivor whose average cost exceeds that of some other
+       survivor by more than the Kim-Nelson half-width
+           W = max(0, delta / (2 r) * (h^2 S^2 / delta^2 - r)),
+       with r the replications so far and S^2 the variance of the pair's
+       differences over the first n0.  The comparison with the best survivor
+       comes first, since it eliminates the most; policies eliminated in this
+       pass still count as survivors for the others. */
+
+    before = num_survivors;
+    for (i = 0; i < num_survivors; ++i) {
+        if (i == best)
+            continue;
+        if (worse(i, best)) {
+            id[i] = -1 - id[i];
+            continue;
+        }
+        for (l = 0; l < num_survivors; ++l)
+            if (l != i && l != best && means[l] < means[i] && worse(i, l)) {
+                id[i] = -1 - id[i];
+                break;
+            }
+    }
+    compact();
+
+    /* Write a line of the elimination trace whenever policies were dropped. */
+
+    if (num_survivors < before || num_survivors == 1)
+        fprintf(outfile, "\n%14d%10d    (%3d,%3d)%13.2f", num_reps,
+                num_survivors, pol.smalls[best], pol.bigs[best],
+                mean_cost(best));
+}
+
+
+void compact(void)  /* Survivor compaction function. */
+{
+    int i, j, best_id;
+
+    /* Move the survivors (those whose id was not negated) to the front of the
+       policy arrays, so that later passes simulate only them. */
+
+    best_id = id[best];
+    j = 0;
+    for (i = 0; i < num_survivors; ++i) {
+        if (id[i] < 0)
+            continue;
+        id[j]         = id[i];
+        pol.smalls[j] = pol.smalls[i];
+        pol.bigs[j]   = pol.bigs[i];
+        if (id[j] == best_id)
+            best = j;
+        ++j;
+    }
+    num_survivors    = j;
+    pol.num_policies = j;
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    int    i, k;
+    double mean_best, s2, diff;
+    float  *cb;
+
+    /* Identify the best survivor and compute a confidence interval for its
+       expected average cost per month. */
+
+    best = 0;
+    for (i = 1; i < num_survivors; ++i)
+        if (mean_cost(i) < mean_cost(best))
+            best = i;
+    mean_best = mean_cost(best);
+    cb        = &cost[(size_t) id[best] * max_reps];
+    s2        = 0.0;
+    for (k = 0; k < num_reps; ++k) {
+        diff = cb[k] - mean_best;
+        s2  += diff * diff;
+    }
+    s2 /= num_reps - 1;
+
+    fprintf(outfile, "\n\nBest policy%28s(%3d,%3d)\n\n", "",
+            pol.smalls[best], pol.bigs[best]);
+    fprintf(outfile, "Average total cost%29.2f +/-%6.2f\n\n", mean_best,
+            1.96 * sqrt(s2 / num_reps));
+    fprintf(outfile, "Replications used%30d\n\n", num_reps);
+
+    /* The error probability holds only if the procedure ran until one policy
+       was left.  Otherwise the best is the one with the smallest average, and
+       the others are within the half-widths of it. */
+
+    if (num_survivors > 1)
+        fprintf(outfile, "Stopped at n_max with %d policies left, so the error"
+                " probability is not guaranteed\n\n", num_survivors);
+    fprintf(outfile, "Policy-replications simulated%18.0f\n\n", policy_reps);
+    fprintf(outfile, "Exhaustive grid would need%21.0f (%5.1f%% used)\n\n",
+            (double) num_candidates * num_reps,
+            100.0 * policy_reps / ((double) num_candidates * num_reps));
+
+    /* Write the surviving policies in the format of inv.out. */
+
+    fprintf(outfile, "                 Average        Average");
+    fprintf(outfile, "        Average        Average\n");
+    fprintf(outfile, "  Policy       total cost    ordering cost");
+    fprintf(outfile, "  holding cost   shortage cost");
+    for (i = 0; i < num_survivors; ++i)
+        fprintf(outfile, "\n\n(%3d,%3d)%15.2f%15.2f%15.2f%15.2f",
+                pol.smalls[i], pol.bigs[i], mean_cost(i),
+                sum_ordering[id[i]] / num_reps,
+                sum_holding[id[i]] / num_reps,
+                sum_shortage[id[i]] / num_reps);
+}
+
+
+double mean_cost(int i)  /* Return the average cost of survivor i over the
+                            replications so far. */
+{
+    int    k;
+    double sum;
+    float  *c;
+
+    c   = &cost[(size_t) id[i] * max_reps];
+    sum = 0.0;
+    for (k = 0; k < num_reps; ++k)
+        sum += c[k];
+    return sum / num_reps;
+}
+
+
+int worse(int i, int l)  /* Return 1 if survivor i is eliminated by survivor
+                           l, or 0. */
+{
+    double w;
+
+    w = delta / (2.0 * num_reps) *
+        (h2 * pair_variance(i, l) / (delta * delta) - num_reps);
+    return means[i] - means[l] > (w > 0.0 ? w : 0.0);
+}
+
+
+double pair_variance(int i, int l)  /* Return the sample variance of the
+                                       cost differences of survivors i and l
+                                       over the first n0 replications. */
+{
+    int    k;
+    double sum, sum_sq, diff;
+    float  *ci, *cl;
+
+    /* Survivors already eliminated in this pass have their id negated. */
+
+    ci     = &cost[(size_t) (id[i] < 0 ? -1 - id[i] : id[i]) * max_reps];
+    cl     = &cost[(size_t) (id[l] < 0 ? -1 - id[l] : id[l]) * max_reps];
+    sum    = 0.0;
+    sum_sq = 0.0;
+    for (k = 0; k < min_reps; ++k) {
+        diff    = ci[k] - cl[k];
+        sum    += diff;
+        sum_sq += diff * diff;
+    }
+    return (sum_sq - sum * sum / min_reps) / (min_reps - 1);
+}
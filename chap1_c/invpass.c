@@ -0,0 +1,239 @@
+/* Single-pass, multi-policy simulation of the inventory system.  See
+   invpass.h for usage. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "invpass.h"  /* Header file for this module. */
+
+static void  advance(struct inv_policies *pol, float t0, float t1);
+static float expon(float mean, long *zp);
+static int   random_integer(float prob_distrib [], long *zp);
+static float uniform(float a, float b, long *zp);
+
+
+int inv_read_params(FILE *infile, struct inv_params *par)  /* Parameter input
+                                                              function. */
+{
+    int i, num_policies;
+
+    /* Read the first two lines of inv.in, and return the number of policies
+       given there. */
+
+    fscanf(infile, "%d %d %d %d %f %f %f %f %f %f %f",
+           &par->initial_inv_level, &par->num_months, &num_policies,
+           &par->num_values_demand, &par->mean_interdemand, &par->setup_cost,
+           &par->incremental_cost, &par->holding_cost, &par->shortage_cost,
+           &par->minlag, &par->maxlag);
+    for (i = 1; i <= par->num_values_demand; ++i)
+        fscanf(infile, "%f", &par->prob_distrib_demand[i]);
+    return num_policies;
+}
+
+
+int inv_read_policies(FILE *infile, struct inv_policies *pol,
+                      int num_policies)  /* Policy input function. */
+{
+    int i, s, bigs, s_lo, s_hi, s_step, bigs_lo, bigs_hi, bigs_step;
+
+    /* If a number of policies was given, read that many (s,S) pairs as in
+       inv.in. */
+
+    if (num_policies > 0) {
+        inv_alloc_policies(pol, num_policies);
+        for (i = 0; i < num_policies; ++i)
+            fscanf(infile, "%d %d", &pol->smalls[i], &pol->bigs[i]);
+        return num_policies;
+    }
+
+    /* Otherwise read a grid "s_lo s_hi s_step S_lo S_hi S_step" and generate
+       every pair on it with S > s. */
+
+    fscanf(infile, "%d %d %d %d %d %d", &s_lo, &s_hi, &s_step, &bigs_lo,
+           &bigs_hi, &bigs_step);
+    if (s_step <= 0 || bigs_step <= 0)
+        return 0;
+    num_policies = 0;
+    for (s = s_lo; s <= s_hi; s += s_step)
+        for (bigs = bigs_lo; bigs <= bigs_hi; bigs += bigs_step)
+            if (bigs > s)
+                ++num_policies;
+    inv_alloc_policies(pol, num_policies);
+    i = 0;
+    for (s = s_lo; s <= s_hi; s += s_step)
+        for (bigs = bigs_lo; bigs <= bigs_hi; bigs += bigs_step)
+            if (bigs > s) {
+                pol->smalls[i] = s;
+                pol->bigs[i]   = bigs;
+                ++i;
+            }
+    return num_policies;
+}
+
+
+void inv_alloc_policies(struct inv_policies *pol, int num_policies)
+    /* Policy array allocation function. */
+{
+    pol->num_policies        = num_policies;
+    pol->smalls              = calloc(num_policies, sizeof(int));
+    pol->bigs                = calloc(num_policies, sizeof(int));
+    pol->inv_level           = calloc(num_policies, sizeof(int));
+    pol->amount              = calloc(num_policies, sizeof(int));
+    pol->time_order_arrival  = calloc(num_policies, sizeof(float));
+    pol->area_holding        = calloc(num_policies, sizeof(float));
+    pol->area_shortage       = calloc(num_policies, sizeof(float));
+    pol->total_ordering_cost = calloc(num_policies, sizeof(float));
+}
+
+
+void inv_free_policies(struct inv_policies *pol)  /* Policy array release
+                                                     function. */
+{
+    free(pol->smalls);
+    free(pol->bigs);
+    free(pol->inv_level);
+    free(pol->amount);
+    free(pol->time_order_arrival);
+    free(pol->area_holding);
+    free(pol->area_shortage);
+    free(pol->total_ordering_cost);
+}
+
+
+void inv_pass(struct inv_params *par, struct inv_policies *pol, long zrng[4])
+    /* Simulate all policies for num_months months against one demand
+       trajectory drawn from the streams zrng[1..3]. */
+{
+    int   i, n, month, order, size;
+    float lag, time_demand, time_last_event;
+
+    n = pol->num_policies;
+
+    /* Initialize the state variables and statistical counters of every
+       policy.  No order is outstanding. */
+
+    for (i = 0; i < n; ++i) {
+        pol->inv_level[i]           = par->initial_inv_level;
+        pol->amount[i]              = 0;
+        pol->time_order_arrival[i]  = 1.0e+30;
+        pol->area_holding[i]        = 0.0;
+        pol->area_shortage[i]       = 0.0;
+        pol->total_ordering_cost[i] = 0.0;
+    }
+
+    time_last_event = 0.0;
+    time_demand     = expon(par->mean_interdemand, &zrng[STREAM_INTERDEMAND]);
+
+    for (month = 0; month < par->num_months; ++month) {
+
+        /* Inventory evaluation at the start of the month.  One delivery lag is
+           drawn per month whether or not any policy orders, so that the lag
+           stream stays synchronized across policies. */
+
+        lag = uniform(par->minlag, par->maxlag, &zrng[STREAM_LAG]);
+        for (i = 0; i < n; ++i) {
+            order = pol->inv_level[i] < pol->smalls[i];
+            size  = pol->bigs[i] - pol->inv_level[i];
+
+            pol->amount[i]               = order ? size : pol->amount[i];
+            pol->total_ordering_cost[i] += order ? par->setup_cost +
+                                           par->incremental_cost * size : 0.0;
+            pol->time_order_arrival[i]   = order ? month + lag :
+                                           pol->time_order_arrival[i];
+        }
+
+        /* Demands during the month, each applied to every policy after
+           accumulating the areas up to it (and any order arrival before it). */
+
+        while (time_demand < month + 1) {
+            size = random_integer(par->prob_distrib_demand,
+                                  &zrng[STREAM_DEMAND_SIZE]);
+            advance(pol, time_last_event, time_demand);
+            for (i = 0; i < n; ++i)
+                pol->inv_level[i] -= size;
+            time_last_event = time_demand;
+            time_demand    += expon(par->mean_interdemand,
+                                    &zrng[STREAM_INTERDEMAND]);
+        }
+
+        /* Accumulate the areas up to the end of the month. */
+
+        advance(pol, time_last_event, month + 1);
+        time_last_event = month + 1;
+    }
+}
+
+
+static void advance(struct inv_policies *pol, float t0, float t1)
+    /* Update area accumulators of every policy over (t0, t1], adding any order
+       that arrives in that interval to the inventory level. */
+{
+    int   arrived, i, n, level, level_after;
+    float split, dt1, dt2;
+
+    n = pol->num_policies;
+    for (i = 0; i < n; ++i) {
+        arrived     = pol->time_order_arrival[i] <= t1;
+        split       = arrived ? pol->time_order_arrival[i] : t1;
+        dt1         = split - t0;
+        dt2         = t1 - split;
+        level       = pol->inv_level[i];
+        level_after = level + (arrived ? pol->amount[i] : 0);
+
+        pol->area_holding[i]  += (level > 0 ? level : 0) * dt1 +
+                                 (level_after > 0 ? level_after : 0) * dt2;
+        pol->area_shortage[i] += (level < 0 ? -level : 0) * dt1 +
+                                 (level_after < 0 ? -level_after : 0) * dt2;
+        pol->inv_level[i]          = level_after;
+        pol->time_order_arrival[i] = arrived ? 1.0e+30 :
+                                     pol->time_order_arrival[i];
+    }
+}
+
+
+float inv_total_cost(struct inv_params *par, struct inv_policies *pol, int i)
+    /* Return the average total cost per month of policy i in the last pass. */
+{
+    return (pol->total_ordering_cost[i] +
+            par->holding_cost * pol->area_holding[i] +
+            par->shortage_cost * pol->area_shortage[i]) / par->num_months;
+}
+
+
+static float expon(float mean, long *zp)  /* Exponential variate generation
+                                             function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrandz(zp));
+}
+
+
+static int random_integer(float prob_distrib[], long *zp)  /* Random integer
+                                                              generation
+                                                              function. */
+{
+    int   i;
+    float u;
+
+    /* Generate a U(0,1) random variate. */
+
+    u = lcgrandz(zp);
+
+    /* Return a random integer in accordance with the (cumulative) distribution
+       function prob_distrib. */
+
+    for (i = 1; u >= prob_distrib[i]; ++i)
+        ;
+    return i;
+}
+
+
+static float uniform(float a, float b, long *zp)  /* Uniform variate generation
+                                                     function. */
+{
+    /* Return a U(a,b) random variate. */
+
+    return a + lcgrandz(zp) * (b - a);
+}
@@ -0,0 +1,36 @@
+/* Declarations for the single-pass, multi-policy simulation of the inventory
+   system of inv.c.  One demand trajectory (interdemand times, demand sizes and
+   one delivery lag per month) is generated per pass and all (s,S) policies are
+   advanced against it together, so that every policy sees exactly the same
+   random numbers.  Policy state is kept as a structure of arrays so that the
+   inner loops run over policies and can be vectorized.  This file (named
+   invpass.h) should be included in any program using these functions by
+   executing
+       #include "invpass.h"
+   before referencing the functions. */
+
+#define STREAM_INTERDEMAND 1  /* Random-number stream for interdemand times. */
+#define STREAM_DEMAND_SIZE 2  /* Random-number stream for demand sizes. */
+#define STREAM_LAG         3  /* Random-number stream for delivery lags. */
+
+struct inv_params {  /* Model parameters, as read from inv.in. */
+    int   initial_inv_level, num_months, num_values_demand;
+    float holding_cost, incremental_cost, maxlag, mean_interdemand, minlag,
+          prob_distrib_demand[26], setup_cost, shortage_cost;
+};
+
+struct inv_policies {  /* Policies and their per-pass state and counters. */
+    int    num_policies;
+    int   *smalls, *bigs, *inv_level, *amount;
+    float *time_order_arrival, *area_holding, *area_shortage,
+          *total_ordering_cost;
+};
+
+int   inv_read_params(FILE *infile, struct inv_params *par);
+int   inv_read_policies(FILE *infile, struct inv_policies *pol,
+                        int num_policies);
+void  inv_alloc_policies(struct inv_policies *pol, int num_policies);
+void  inv_free_policies(struct inv_policies *pol);
+void  inv_pass(struct inv_params *par, struct inv_policies *pol,
+               long zrng[4]);
+float inv_total_cost(struct inv_params *par, struct inv_policies *pol, int i);
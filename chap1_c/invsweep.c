@@ -0,0 +1,436 @@
+/* External definitions for parallel (s,S) policy sweep of the inventory
+   system. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+#define THREAD_LIMIT         256  /* Limit on number of worker threads. */
+#define POLICY_CHUNK          16  /* Policies claimed by a worker at a time. */
+#define STREAM_INTERDEMAND     1  /* Random-number stream for interdemand
+                                     times. */
+#define STREAM_DEMAND_SIZE     2  /* Random-number stream for demand sizes. */
+#define STREAM_LAG             3  /* Random-number stream for delivery lags. */
+
+struct policy {  /* State, random-number streams and results of the simulation
+                    of one (s,S) policy. */
+    int   smalls, bigs, amount, inv_level, next_event_type;
+    float area_holding, area_shortage, sim_time, time_last_event,
+          time_next_event[5], total_ordering_cost;
+    long  zrng[4];
+    float avg_holding_cost, avg_ordering_cost, avg_shortage_cost;
+};
+
+int   initial_inv_level, next_policy, num_events, num_months, num_policies,
+      num_threads, num_values_demand;
+float holding_cost, incremental_cost, maxlag, mean_interdemand, minlag,
+      prob_distrib_demand[26], setup_cost, shortage_cost;
+long  zset[4];
+struct policy *policies;
+FILE  *infile, *outfile;
+
+int   read_policies(void);
+void *worker(void *arg);
+void  simulate(struct policy *p);
+void  initialize(struct policy *p);
+void  timing(struct policy *p);
+void  order_arrival(struct policy *p);
+void  demand(struct policy *p);
+void  evaluate(struct policy *p);
+void  report(void);
+void  update_time_avg_stats(struct policy *p);
+float expon(float mean, long *zp);
+int   random_integer(float prob_distrib [], long *zp);
+float uniform(float a, float b, long *zp);
+
+
+int main()  /* Main function. */
+{
+    int       i, num_started;
+    pthread_t threads[THREAD_LIMIT];
+
+    /* Open input and output files. */
+
+    infile  = fopen("invsweep.in",  "r");
+    outfile = fopen("invsweep.out", "w");
+
+    /* Specify the number of events for the timing function. */
+
+    num_events = 4;
+
+    /* Read input parameters.  They are those of inv.in, followed by the number
+       of worker threads (0 means one per online processor). */
+
+    fscanf(infile, "%d %d %d %d %f %f %f %f %f %f %f",
+           &initial_inv_level, &num_months, &num_policies, &num_values_demand,
+           &mean_interdemand, &setup_cost, &incremental_cost, &holding_cost,
+           &shortage_cost, &minlag, &maxlag);
+    for (i = 1; i <= num_values_demand; ++i)
+        fscanf(infile, "%f", &prob_distrib_demand[i]);
+    fscanf(infile, "%d", &num_threads);
+    if (num_threads <= 0)
+        num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_threads > THREAD_LIMIT)
+        num_threads = THREAD_LIMIT;
+
+    /* Read or generate the policies to be evaluated. */
+
+    if (read_policies() == 0) {
+        fprintf(outfile, "\nNo policies to evaluate");
+        exit(1);
+    }
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Single-product inventory system, parallel policy");
+    fprintf(outfile, " sweep\n\n");
+    fprintf(outfile, "Initial inventory level%24d items\n\n",
+            initial_inv_level);
+    fprintf(outfile, "Number of demand sizes%25d\n\n", num_values_demand);
+    fprintf(outfile, "Distribution function of demand sizes  ");
+    for (i = 1; i <= num_values_demand; ++i)
+        fprintf(outfile, "%8.3f", prob_distrib_demand[i]);
+    fprintf(outfile, "\n\nMean interdemand time%26.2f\n\n", mean_interdemand);
+    fprintf(outfile, "Delivery lag range%29.2f to%10.2f months\n\n", minlag,
+            maxlag);
+    fprintf(outfile, "Length of the simulation%23d months\n\n", num_months);
+    fprintf(outfile, "K =%6.1f   i =%6.1f   h =%6.1f   pi =%6.1f\n\n",
+            setup_cost, incremental_cost, holding_cost, shortage_cost);
+    fprintf(outfile, "Number of policies%29d\n\n", num_policies);
+    fprintf(outfile, "Number of threads%30d\n\n", num_threads);
+    fprintf(outfile, "                 Average        Average");
+    fprintf(outfile, "        Average        Average\n");
+    fprintf(outfile, "  Policy       total cost    ordering cost");
+    fprintf(outfile, "  holding cost   shortage cost");
+
+    /* Every policy starts from the same seeds, so that all policies see the
+       same demands (common random numbers).  Interdemand times, demand sizes
+       and delivery lags use separate streams to keep them synchronized across
+       policies that order at different times. */
+
+    zset[STREAM_INTERDEMAND] = lcgrandgt(STREAM_INTERDEMAND);
+    zset[STREAM_DEMAND_SIZE] = lcgrandgt(STREAM_DEMAND_SIZE);
+    zset[STREAM_LAG]         = lcgrandgt(STREAM_LAG);
+
+    /* Run the simulations of all policies on the pool of worker threads.  The
+       workers claim policies until none remain, so if not all the threads can
+       be started, those that were simulate all the policies. */
+
+    next_policy = 0;
+    for (num_started = 0; num_started < num_threads; ++num_started)
+        if (pthread_create(&threads[num_started], NULL, worker, NULL) != 0)
+            break;
+    if (num_started == 0) {
+        fprintf(outfile, "\nCannot start a worker thread");
+        exit(3);
+    }
+    if (num_started < num_threads)
+        fprintf(stderr, "Started only %d of %d worker threads\n", num_started,
+                num_threads);
+    for (i = 0; i < num_started; ++i)
+        pthread_join(threads[i], NULL);
+
+    /* Invoke the report generator and end the simulations. */
+
+    report();
+
+    free(policies);
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+int read_policies(void)  /* Policy input function. */
+{
+    int i, s, bigs, s_lo, s_hi, s_step, bigs_lo, bigs_hi, bigs_step;
+
+    /* If a number of policies was given, read that many (s,S) pairs as in
+       inv.in. */
+
+    if (num_policies > 0) {
+        policies = calloc(num_policies, sizeof(struct policy));
+        for (i = 0; i < num_policies; ++i)
+            fscanf(infile, "%d %d", &policies[i].smalls, &policies[i].bigs);
+        return num_policies;
+    }
+
+    /* Otherwise read a grid "s_lo s_hi s_step S_lo S_hi S_step" and generate
+       every pair on it with S > s. */
+
+    fscanf(infile, "%d %d %d %d %d %d", &s_lo, &s_hi, &s_step, &bigs_lo,
+           &bigs_hi, &bigs_step);
+    if (s_step <= 0 || bigs_step <= 0)
+        return 0;
+    num_policies = 0;
+    for (s = s_lo; s <= s_hi; s += s_step)
+        for (bigs = bigs_lo; bigs <= bigs_hi; bigs += bigs_step)
+            if (bigs > s)
+                ++num_policies;
+    policies = calloc(num_policies, sizeof(struct policy));
+    i = 0;
+    for (s = s_lo; s <= s_hi; s += s_step)
+        for (bigs = bigs_lo; bigs <= bigs_hi; bigs += bigs_step)
+            if (bigs > s) {
+                policies[i].smalls = s;
+                policies[i].bigs   = bigs;
+                ++i;
+            }
+    return num_policies;
+}
+
+
+void *worker(void *arg)  /* Worker thread function. */
+{
+    int first, last, i;
+
+    (void) arg;
+
+    /* Repeatedly claim the next chunk of policies and simulate each of them,
+       until no policies remain. */
+
+    for (;;) {
+        first = __sync_fetch_and_add(&next_policy, POLICY_CHUNK);
+        if (first >= num_policies)
+            break;
+        last = first + POLICY_CHUNK;
+        if (last > num_policies)
+            last = num_policies;
+        for (i = first; i < last; ++i)
+            simulate(&policies[i]);
+    }
+    return NULL;
+}
+
+
+void simulate(struct policy *p)  /* Simulation function for one policy. */
+{
+    /* Initialize the simulation. */
+
+    initialize(p);
+
+    /* Run the simulation until it terminates after an end-simulation event
+       (type 3) occurs. */
+
+    do {
+
+        /* Determine the next event. */
+
+        timing(p);
+
+        /* Update time-average statistical accumulators. */
+
+        update_time_avg_stats(p);
+
+        /* Invoke the appropriate event function. */
+
+        switch (p->next_event_type) {
+            case 1:
+                order_arrival(p);
+                break;
+            case 2:
+                demand(p);
+                break;
+            case 4:
+                evaluate(p);
+                break;
+        }
+
+    } while (p->next_event_type != 3);
+
+    /* Compute estimates of desired measures of performance. */
+
+    p->avg_ordering_cost = p->total_ordering_cost / num_months;
+    p->avg_holding_cost  = holding_cost * p->area_holding / num_months;
+    p->avg_shortage_cost = shortage_cost * p->area_shortage / num_months;
+}
+
+
+void initialize(struct policy *p)  /* Initialization function. */
+{
+    /* Initialize the simulation clock. */
+
+    p->sim_time = 0.0;
+
+    /* Initialize the state variables and the policy's private copies of the
+       random-number streams. */
+
+    p->inv_level       = initial_inv_level;
+    p->time_last_event = 0.0;
+    p->zrng[STREAM_INTERDEMAND] = zset[STREAM_INTERDEMAND];
+    p->zrng[STREAM_DEMAND_SIZE] = zset[STREAM_DEMAND_SIZE];
+    p->zrng[STREAM_LAG]         = zset[STREAM_LAG];
+
+    /* Initialize the statistical counters. */
+
+    p->total_ordering_cost = 0.0;
+    p->area_holding        = 0.0;
+    p->area_shortage       = 0.0;
+
+    /* Initialize the event list.  Since no order is outstanding, the order-
+       arrival event is eliminated from consideration. */
+
+    p->time_next_event[1] = 1.0e+30;
+    p->time_next_event[2] = p->sim_time +
+                            expon(mean_interdemand,
+                                  &p->zrng[STREAM_INTERDEMAND]);
+    p->time_next_event[3] = num_months;
+    p->time_next_event[4] = 0.0;
+}
+
+
+void timing(struct policy *p)  /* Timing function. */
+{
+    int   i;
+    float min_time_next_event = 1.0e+29;
+
+    p->next_event_type = 0;
+
+    /* Determine the event type of the next event to occur.  The end-simulation
+       event is always pending, so the event list cannot be empty. */
+
+    for (i = 1; i <= num_events; ++i)
+        if (p->time_next_event[i] < min_time_next_event) {
+            min_time_next_event = p->time_next_event[i];
+            p->next_event_type  = i;
+        }
+
+    /* Advance the simulation clock. */
+
+    p->sim_time = min_time_next_event;
+}
+
+
+void order_arrival(struct policy *p)  /* Order arrival event function. */
+{
+    /* Increment the inventory level by the amount ordered. */
+
+    p->inv_level += p->amount;
+
+    /* Since no order is now outstanding, eliminate the order-arrival event from
+       consideration. */
+
+    p->time_next_event[1] = 1.0e+30;
+}
+
+
+void demand(struct policy *p)  /* Demand event function. */
+{
+    /* Decrement the inventory level by a generated demand size. */
+
+    p->inv_level -= random_integer(prob_distrib_demand,
+                                   &p->zrng[STREAM_DEMAND_SIZE]);
+
+    /* Schedule the time of the next demand. */
+
+    p->time_next_event[2] = p->sim_time +
+                            expon(mean_interdemand,
+                                  &p->zrng[STREAM_INTERDEMAND]);
+}
+
+
+void evaluate(struct policy *p)  /* Inventory-evaluation event function. */
+{
+    /* Check whether the inventory level is less than smalls. */
+
+    if (p->inv_level < p->smalls) {
+
+        /* The inventory level is less than smalls, so place an order for the
+           appropriate amount. */
+
+        p->amount               = p->bigs - p->inv_level;
+        p->total_ordering_cost += setup_cost + incremental_cost * p->amount;
+
+        /* Schedule the arrival of the order. */
+
+        p->time_next_event[1] = p->sim_time +
+                                uniform(minlag, maxlag, &p->zrng[STREAM_LAG]);
+    }
+
+    /* Regardless of the place-order decision, schedule the next inventory
+       evaluation. */
+
+    p->time_next_event[4] = p->sim_time + 1.0;
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    int            i;
+    struct policy *p;
+
+    /* Write the estimates of desired measures of performance for every
+       policy, in input order. */
+
+    for (i = 0; i < num_policies; ++i) {
+        p = &policies[i];
+        fprintf(outfile, "\n\n(%3d,%3d)%15.2f%15.2f%15.2f%15.2f",
+                p->smalls, p->bigs,
+                p->avg_ordering_cost + p->avg_holding_cost +
+                p->avg_shortage_cost,
+                p->avg_ordering_cost, p->avg_holding_cost,
+                p->avg_shortage_cost);
+    }
+}
+
+
+void update_time_avg_stats(struct policy *p)  /* Update area accumulators for
+                                                 time-average statistics. */
+{
+    float time_since_last_event;
+
+    /* Compute time since last event, and update last-event-time marker. */
+
+    time_since_last_event = p->sim_time - p->time_last_event;
+    p->time_last_event    = p->sim_time;
+
+    /* Determine the status of the inventory level during the previous interval.
+       If the inventory level during the previous interval was negative, update
+       area_shortage.  If it was positive, update area_holding.  If it was zero,
+       no update is needed. */
+
+    if (p->inv_level < 0)
+        p->area_shortage -= p->inv_level * time_since_last_event;
+    else if (p->inv_level > 0)
+        p->area_holding  += p->inv_level * time_since_last_event;
+}
+
+
+float expon(float mean, long *zp)  /* Exponential variate generation
+                                      function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrandz(zp));
+}
+
+
+int random_integer(float prob_distrib[], long *zp)  /* Random integer generation
+                                                       function. */
+{
+    int   i;
+    float u;
+
+    /* Generate a U(0,1) random variate. */
+
+    u = lcgrandz(zp);
+
+    /* Return a random integer in accordance with the (cumulative) distribution
+       function prob_distrib. */
+
+    for (i = 1; u >= prob_distrib[i]; ++i)
+        ;
+    return i;
+}
+
+
+float uniform(float a, float b, long *zp)  /* Uniform variate generation
+                                              function. */
+{
+    /* Return a U(a,b) random variate. */
+
+    return a + lcgrandz(zp) * (b - a);
+}
@@ -1,11 +1,14 @@
-/* The following 3 declarations are for use of the random-number generator
-   lcgrand and the associated functions lcgrandst and lcgrandgt for seed
-   management.  This file (named lcgrand.h) should be included in any program
-   using these functions by executing
+/* The following 5 declarations are for use of the random-number generator
+   lcgrand, its caller-held-seed form lcgrandz, and the associated functions
+   lcgrandst and lcgrandgt for seed management and lcgrandjp for jumping
+   ahead in the sequence.  This file (named lcgrand.h)
+   should be included in any program using these functions by executing
        #include "lcgrand.h"
    before referencing the functions. */
 
 float lcgrand(int stream);
 void  lcgrandst(long zset, int stream);
 long  lcgrandgt(int stream);
+float lcgrandz(long *zp);
+long  lcgrandjp(long z, long k);
 
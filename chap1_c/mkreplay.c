@@ -0,0 +1,85 @@
+/* Converter from text to replay files (see replay.h).
+
+   Usage: mkreplay text_file replay_file
+
+   Each line of the text file holds the arrival time of a customer followed by
+   its service time at each station, separated by blanks; the number of
+   stations is taken from the first line.  Arrival times must be
+   nondecreasing. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"  /* Header file for replay format. */
+
+#define LINE_LIMIT 1024  /* Limit on length of a text line. */
+
+
+int main(int argc, char *argv[])  /* Main function. */
+{
+    char                 line[LINE_LIMIT], *p, *end;
+    double               fields[REPLAY_STATION_LIMIT + 2], time_last;
+    int                  n, num_fields;
+    long                 line_number;
+    struct replay_header header;
+    FILE                 *infile, *outfile;
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: mkreplay text_file replay_file\n");
+        return 1;
+    }
+    infile  = fopen(argv[1], "r");
+    outfile = fopen(argv[2], "wb");
+    if (infile == NULL || outfile == NULL) {
+        fprintf(stderr, "Cannot open %s\n", infile ? argv[2] : argv[1]);
+        return 1;
+    }
+
+    /* Reserve room for the header, which is written once the number of
+       records is known. */
+
+    memset(&header, 0, sizeof(header));
+    fwrite(&header, sizeof(header), 1, outfile);
+
+    num_fields  = 0;
+    line_number = 0;
+    time_last   = 0.0;
+    while (fgets(line, LINE_LIMIT, infile) != NULL) {
+        ++line_number;
+
+        /* Parse the fields of the line, skipping blank lines. */
+
+        n = 0;
+        for (p = line; n < REPLAY_STATION_LIMIT + 2; p = end) {
+            fields[n] = strtod(p, &end);
+            if (end == p)
+                break;
+            ++n;
+        }
+        if (n == 0)
+            continue;
+        if (num_fields == 0)
+            num_fields = n;
+        if (n != num_fields || n < 2 || n > REPLAY_STATION_LIMIT + 1 ||
+            fields[0] < time_last) {
+            fprintf(stderr, "%s, line %ld: expected %d nondecreasing fields\n",
+                    argv[1], line_number, num_fields);
+            return 1;
+        }
+        time_last = fields[0];
+        fwrite(fields, sizeof(double), n, outfile);
+        ++header.num_records;
+    }
+
+    /* Write the header. */
+
+    header.magic        = REPLAY_MAGIC;
+    header.version      = REPLAY_VERSION;
+    header.num_services = num_fields - 1;
+    fseek(outfile, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, outfile);
+
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
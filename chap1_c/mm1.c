@@ -4,8 +4,14 @@
 #include <stdlib.h>
 #include <math.h>
 #include "lcgrand.h"  /* Header file for random-number generator. */
+#include "bench.h"    /* Header file for benchmark hooks. */
+#include "instr.h"    /* Header file for instrumentation hooks. */
+#include "results.h"  /* Header file for machine-readable results. */
+#include "replay.h"   /* Header file for trace-driven input. */
 
+#ifndef Q_LIMIT
 #define Q_LIMIT 100  /* Limit on queue length. */
+#endif
 #define BUSY      1  /* Mnemonics for server's being busy */
 #define IDLE      0  /* and idle. */
 
@@ -31,11 +37,16 @@ int main()  /* Main function. */
 
     infile  = fopen("mm1.in",  "r");
     outfile = fopen("mm1.out", "w");
+    RESULTS_OPEN("mm1", 1);
 
     /* Specify the number of events for the timing function. */
 
     num_events = 2;
 
+    /* Map the trace, when replaying one. */
+
+    REPLAY_OPEN("mm1.rep", 1);
+
     /* Read input parameters. */
 
     fscanf(infile, "%f %f %d", &mean_interarrival, &mean_service,
@@ -48,9 +59,12 @@ int main()  /* Main function. */
             mean_interarrival);
     fprintf(outfile, "Mean service time%16.3f minutes\n\n", mean_service);
     fprintf(outfile, "Number of customers%14d\n\n", num_delays_required);
+    REPLAY_REPORT(outfile, "mm1.rep");
 
     /* Initialize the simulation. */
     
+	BENCH_START();
+	RESULTS_START(0);
 	initialize();
 
 	/* Run the simulation while more delays are still needed. */
@@ -59,14 +73,20 @@ int main()  /* Main function. */
 
 		/* Determine the next event. */
 
+		INSTR_BEGIN(INSTR_TIMING);
 		timing();
+		INSTR_END(INSTR_TIMING);
+		BENCH_EVENT();
 
 		/* Update time-average statistical accumulators. */
 
+		INSTR_BEGIN(INSTR_STATS);
 		update_time_avg_stats();
+		INSTR_END(INSTR_STATS);
 
 		/* Invoke the appropriate event function. */
 
+		INSTR_BEGIN(INSTR_EVENT(next_event_type));
 		switch (next_event_type) {
 			case 1:
 				arrive();
@@ -75,12 +95,16 @@ int main()  /* Main function. */
 				depart();
 				break;
 		}
+		INSTR_END(INSTR_EVENT(next_event_type));
 	}
 
     /* Invoke the report generator and end the simulation. */
 
+    BENCH_STOP();
     report();
 
+    REPLAY_CLOSE();
+    RESULTS_CLOSE();
     fclose(infile);
     fclose(outfile);
 
@@ -108,9 +132,11 @@ void initialize(void)  /* Initialization function. */
     area_server_status = 0.0;
 
     /* Initialize event list.  Since no customers are present, the departure
-       (service completion) event is eliminated from consideration. */
+       (service completion) event is eliminated from consideration.  When
+       replaying, the first customer is the next one in the trace. */
 
-    time_next_event[1] = sim_time + expon(mean_interarrival);
+    REPLAY_ALIGN();
+    time_next_event[1] = sim_time + REPLAY_ARRIVAL(expon(mean_interarrival));
     time_next_event[2] = 1.0e+30;
 }
 
@@ -134,8 +160,10 @@ void timing(void)  /* Timing function. */
 
     if (next_event_type == 0) {
 
-        /* The event list is empty, so stop the simulation. */
+        /* The event list is empty, so stop the simulation.  When replaying,
+           this means that the trace has run out of arrivals. */
 
+        REPLAY_EXHAUSTED(outfile, sim_time);
         fprintf(outfile, "\nEvent list empty at time %f", sim_time);
         exit(1);
     }
@@ -152,7 +180,7 @@ void arrive(void)  /* Arrival event function. */
 
     /* Schedule next arrival. */
 
-    time_next_event[1] = sim_time + expon(mean_interarrival);
+    time_next_event[1] = sim_time + REPLAY_ARRIVAL(expon(mean_interarrival));
 
     /* Check to see whether server is busy. */
 
@@ -177,6 +205,7 @@ void arrive(void)  /* Arrival event function. */
            arriving customer at the (new) end of time_arrival. */
 
         time_arrival[num_in_q] = sim_time;
+        BENCH_QUEUE(num_in_q);
     }
 
     else {
@@ -195,7 +224,7 @@ void arrive(void)  /* Arrival event function. */
 
         /* Schedule a departure (service completion). */
 
-        time_next_event[2] = sim_time + expon(mean_service);
+        time_next_event[2] = sim_time + REPLAY_SERVICE(1, expon(mean_service));
     }
 }
 
@@ -232,10 +261,11 @@ void depart(void)  /* Departure event function. */
         /* Increment the number of customers delayed, and schedule departure. */
 
         ++num_custs_delayed;
-        time_next_event[2] = sim_time + expon(mean_service);
+        time_next_event[2] = sim_time + REPLAY_SERVICE(1, expon(mean_service));
 
         /* Move each customer in queue (if any) up one place. */
 
+        INSTR_SHIFT(num_in_q);
         for (i = 1; i <= num_in_q; ++i)
             time_arrival[i] = time_arrival[i + 1];
     }
@@ -253,6 +283,18 @@ void report(void)  /* Report generator function. */
     fprintf(outfile, "Server utilization%15.3f\n\n",
             area_server_status / sim_time);
     fprintf(outfile, "Time simulation ended%12.3f minutes", sim_time);
+    INSTR_REPORT(outfile);
+
+    /* Write the parameters and measures as a machine-readable row. */
+
+    RESULTS_REAL("mean_interarrival", mean_interarrival);
+    RESULTS_REAL("mean_service", mean_service);
+    RESULTS_INT("num_delays_required", num_delays_required);
+    RESULTS_REAL("avg_delay_in_queue", total_of_delays / num_custs_delayed);
+    RESULTS_REAL("avg_num_in_queue", area_num_in_q / sim_time);
+    RESULTS_REAL("server_utilization", area_server_status / sim_time);
+    RESULTS_REAL("time_end", sim_time);
+    RESULTS_ROW();
 }
 
 
@@ -278,8 +320,13 @@ void update_time_avg_stats(void)  /* Update area accumulators for time-average
 
 float expon(float mean)  /* Exponential variate generation function. */
 {
+    float x;
+
     /* Return an exponential random variate with mean "mean". */
 
-    return -mean * log(lcgrand(1));
+    INSTR_RNG_BEGIN();
+    x = -mean * log(lcgrand(1));
+    INSTR_RNG_END(1);
+    return x;
 }
 
@@ -0,0 +1,180 @@
+/* Single-server queueing system on the compile-time engine of sim.hpp.  It
+   reads mm1.in and writes the report of mm1.c to mm1cpp.out. */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "sim.hpp"    /* Header file for the simulation engine. */
+extern "C" {
+#include "lcgrand.h"  /* Header file for random-number generator. */
+}
+
+#ifndef Q_LIMIT
+#define Q_LIMIT 100  /* Limit on queue length. */
+#endif
+#define BUSY      1  /* Mnemonics for server's being busy */
+#define IDLE      0  /* and idle. */
+
+struct arrival {};    /* Event types. */
+struct departure {};
+
+struct mm1 : sim::engine<mm1, arrival, departure> {
+    int   num_custs_delayed, num_delays_required, num_in_q, server_status;
+    float area_num_in_q, area_server_status, mean_interarrival, mean_service,
+          time_arrival[Q_LIMIT + 1], total_of_delays;
+    FILE  *outfile;
+
+    void initialize()  /* Initialization function. */
+    {
+        /* Initialize the simulation clock and the state variables. */
+
+        start();
+        server_status = IDLE;
+        num_in_q      = 0;
+
+        /* Initialize the statistical counters. */
+
+        num_custs_delayed  = 0;
+        total_of_delays    = 0.0;
+        area_num_in_q      = 0.0;
+        area_server_status = 0.0;
+
+        /* Initialize event list.  Since no customers are present, the
+           departure (service completion) event is eliminated from
+           consideration. */
+
+        schedule<arrival>(sim_time + expon(mean_interarrival));
+        cancel<departure>();
+    }
+
+    void handle(arrival)  /* Arrival event function. */
+    {
+        /* Schedule next arrival. */
+
+        schedule<arrival>(sim_time + expon(mean_interarrival));
+
+        /* Check to see whether server is busy. */
+
+        if (server_status == BUSY) {
+
+            /* Server is busy, so increment number of customers in queue, and
+               check to see whether an overflow condition exists. */
+
+            if (++num_in_q > Q_LIMIT) {
+                std::fprintf(outfile, "\nOverflow of the array time_arrival at");
+                std::fprintf(outfile, " time %f", sim_time);
+                std::exit(2);
+            }
+            time_arrival[num_in_q] = sim_time;
+            BENCH_QUEUE(num_in_q);
+        }
+
+        else {
+
+            /* Server is idle, so arriving customer has a delay of zero.
+               Increment the number of customers delayed, make server busy,
+               and schedule a departure. */
+
+            ++num_custs_delayed;
+            server_status = BUSY;
+            schedule<departure>(sim_time + expon(mean_service));
+        }
+    }
+
+    void handle(departure)  /* Departure event function. */
+    {
+        int i;
+
+        /* Check to see whether the queue is empty. */
+
+        if (num_in_q == 0) {
+
+            /* The queue is empty so make the server idle and eliminate the
+               departure (service completion) event from consideration. */
+
+            server_status = IDLE;
+            cancel<departure>();
+        }
+
+        else {
+
+            /* The queue is nonempty, so the first customer in queue begins
+               service.  Update the total delay accumulator, schedule
+               departure, and move each customer in queue up one place. */
+
+            --num_in_q;
+            total_of_delays += sim_time - time_arrival[1];
+            ++num_custs_delayed;
+            schedule<departure>(sim_time + expon(mean_service));
+            for (i = 1; i <= num_in_q; ++i)
+                time_arrival[i] = time_arrival[i + 1];
+        }
+    }
+
+    void update_time_avg_stats(float time_since_last_event)  /* Update area
+                                   accumulators for time-average statistics. */
+    {
+        area_num_in_q      += num_in_q * time_since_last_event;
+        area_server_status += server_status * time_since_last_event;
+    }
+
+    void report()  /* Report generator function. */
+    {
+        std::fprintf(outfile, "\n\nAverage delay in queue%11.3f minutes\n\n",
+                     total_of_delays / num_custs_delayed);
+        std::fprintf(outfile, "Average number in queue%10.3f\n\n",
+                     area_num_in_q / sim_time);
+        std::fprintf(outfile, "Server utilization%15.3f\n\n",
+                     area_server_status / sim_time);
+        std::fprintf(outfile, "Time simulation ended%12.3f minutes", sim_time);
+    }
+
+    static float expon(float mean)  /* Exponential variate generation
+                                       function. */
+    {
+        /* Return an exponential random variate with mean "mean", computing
+           the logarithm in double precision as mm1.c does. */
+
+        return -mean * std::log(static_cast<double>(lcgrand(1)));
+    }
+};
+
+static mm1 model;
+
+
+int main()  /* Main function. */
+{
+    FILE *infile;
+
+    /* Open input and output files, and read input parameters. */
+
+    infile        = std::fopen("mm1.in",  "r");
+    model.outfile = std::fopen("mm1cpp.out", "w");
+    std::fscanf(infile, "%f %f %d", &model.mean_interarrival,
+                &model.mean_service, &model.num_delays_required);
+
+    /* Write report heading and input parameters. */
+
+    std::fprintf(model.outfile, "Single-server queueing system\n\n");
+    std::fprintf(model.outfile, "Mean interarrival time%11.3f minutes\n\n",
+                 model.mean_interarrival);
+    std::fprintf(model.outfile, "Mean service time%16.3f minutes\n\n",
+                 model.mean_service);
+    std::fprintf(model.outfile, "Number of customers%14d\n\n",
+                 model.num_delays_required);
+
+    /* Run the simulation while more delays are still needed. */
+
+    BENCH_START();
+    model.initialize();
+    while (model.num_custs_delayed < model.num_delays_required)
+        model.step();
+    BENCH_STOP();
+
+    /* Invoke the report generator and end the simulation. */
+
+    model.report();
+    std::fclose(infile);
+    std::fclose(model.outfile);
+    return 0;
+}
@@ -1,10 +1,16 @@
 /* External definitions for single-server queueing system, fixed run length. */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
 #include "lcgrand.h"  /* Header file for random-number generator. */
+#include "bench.h"    /* Header file for benchmark hooks. */
+#include "instr.h"    /* Header file for instrumentation hooks. */
+#include "results.h"  /* Header file for machine-readable results. */
 
+#ifndef Q_LIMIT
 #define Q_LIMIT 100  /* Limit on queue length. */
+#endif
 #define BUSY      1  /* Mnemonics for server's being busy */
 #define IDLE      0  /* and idle. */
 
@@ -23,12 +29,13 @@ void  update_time_avg_stats(void);
 float expon(float mean);
 
 
-main()  /* Main function. */
+int main()  /* Main function. */
 {
     /* Open input and output files. */
 
     infile  = fopen("mm1alt.in",  "r");
     outfile = fopen("mm1alt.out", "w");
+    RESULTS_OPEN("mm1alt", 1);
 
     /* Specify the number of events for the timing function. */
 
@@ -49,6 +56,8 @@ main()  /* Main function. */
 
     /* Initialize the simulation. */
 
+    BENCH_START();
+    RESULTS_START(0);
     initialize();
 
     /* Run the simulation until it terminates after an end-simulation event
@@ -58,30 +67,42 @@ main()  /* Main function. */
 
         /* Determine the next event. */
 
+        INSTR_BEGIN(INSTR_TIMING);
         timing();
+        INSTR_END(INSTR_TIMING);
+        BENCH_EVENT();
 
         /* Update time-average statistical accumulators. */
 
+        INSTR_BEGIN(INSTR_STATS);
         update_time_avg_stats();
-
-        /* Invoke the appropriate event function. */
-
-        switch (next_event_type) {
-            case 1:
-                arrive();
-                break;
-            case 2:
-                depart();
-                break;
-            case 3:
-                report();
-                break;
+        INSTR_END(INSTR_STATS);
+
+        /* Invoke the appropriate event function.  The end-simulation
+           event is not timed, since report() writes the instrumentation
+           figures. */
+
+        if (next_event_type == 3)
+            report();
+        else {
+            INSTR_BEGIN(INSTR_EVENT(next_event_type));
+            switch (next_event_type) {
+                case 1:
+                    arrive();
+                    break;
+                case 2:
+                    depart();
+                    break;
+            }
+            INSTR_END(INSTR_EVENT(next_event_type));
         }
 
     /* If the event just executed was not the end-simulation event (type 3),
        continue simulating.  Otherwise, end the simulation. */
 
     } while (next_event_type != 3);
+    BENCH_STOP();
+    RESULTS_CLOSE();
 
     fclose(infile);
     fclose(outfile);
@@ -181,6 +202,7 @@ void arrive(void)  /* Arrival event function. */
            arriving customer at the (new) end of time_arrival. */
 
         time_arrival[num_in_q] = sim_time;
+        BENCH_QUEUE(num_in_q);
     }
 
     else {
@@ -240,6 +262,7 @@ void depart(void)  /* Departure event function. */
 
         /* Move each customer in queue (if any) up one place. */
 
+        INSTR_SHIFT(num_in_q);
         for (i = 1; i <= num_in_q; ++i)
             time_arrival[i] = time_arrival[i + 1];
     }
@@ -258,6 +281,18 @@ void report(void)  /* Report generator function. */
             area_server_status / sim_time);
     fprintf(outfile, "Number of delays completed%7d",
             num_custs_delayed);
+    INSTR_REPORT(outfile);
+
+    /* Write the parameters and measures as a machine-readable row. */
+
+    RESULTS_REAL("mean_interarrival", mean_interarrival);
+    RESULTS_REAL("mean_service", mean_service);
+    RESULTS_REAL("time_end", time_end);
+    RESULTS_REAL("avg_delay_in_queue", total_of_delays / num_custs_delayed);
+    RESULTS_REAL("avg_num_in_queue", area_num_in_q / sim_time);
+    RESULTS_REAL("server_utilization", area_server_status / sim_time);
+    RESULTS_INT("num_delays_completed", num_custs_delayed);
+    RESULTS_ROW();
 }
 
 
@@ -283,8 +318,13 @@ void update_time_avg_stats(void)  /* Update area accumulators for time-average
 
 float expon(float mean)  /* Exponential variate generation function. */
 {
+    float x;
+
     /* Return an exponential random variate with mean "mean". */
 
-    return -mean * log(lcgrand(1));
+    INSTR_RNG_BEGIN();
+    x = -mean * log(lcgrand(1));
+    INSTR_RNG_END(1);
+    return x;
 }
 
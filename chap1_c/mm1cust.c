@@ -0,0 +1,344 @@
+/* External definitions for single-server queueing system with customer
+   records and an event list drawn from fixed-capacity pools. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "pool.h"     /* Header file for pool allocator. */
+
+#ifndef Q_LIMIT
+#define Q_LIMIT 100  /* Limit on queue length. */
+#endif
+#define EVENT_LIMIT 4  /* Limit on number of scheduled events. */
+#define BUSY      1  /* Mnemonics for server's being busy */
+#define IDLE      0  /* and idle. */
+#define ARRIVAL   1  /* Event types. */
+#define DEPARTURE 2
+
+struct customer {  /* Customer record. */
+    float            time_arrival;
+    long             number;
+    struct customer *next;
+};
+
+struct event {  /* Event list node. */
+    float            time;
+    int              type;
+    struct customer *customer;
+    struct event    *next;
+};
+
+int   num_custs_delayed, num_delays_required, num_in_q, num_replications,
+      server_status;
+long  num_arrivals;
+float area_num_in_q, area_server_status, mean_interarrival, mean_service,
+      sim_time, time_last_event, total_of_delays;
+struct pool      customer_pool, event_pool;
+struct customer *queue_head, *queue_tail;
+struct event    *event_list, *current_event;
+FILE  *infile, *outfile;
+
+void  initialize(void);
+void  schedule(float time, int type, struct customer *customer);
+void  timing(void);
+void  arrive(void);
+void  depart(void);
+void  report(int replication);
+void  update_time_avg_stats(void);
+float expon(float mean);
+
+
+int main()  /* Main function. */
+{
+    int i;
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm1cust.in",  "r");
+    outfile = fopen("mm1cust.out", "w");
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%f %f %d %d", &mean_interarrival, &mean_service,
+           &num_delays_required, &num_replications);
+
+    /* Allocate the pools once; initialize() empties them for each
+       replication.  Customers in queue and in service come from the customer
+       pool, so its capacity is one more than the queue limit. */
+
+    if (pool_init(&customer_pool, sizeof(struct customer), Q_LIMIT + 1) != 0 ||
+        pool_init(&event_pool, sizeof(struct event), EVENT_LIMIT) != 0) {
+        fprintf(outfile, "\nCannot allocate the pools");
+        exit(3);
+    }
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Single-server queueing system with customer");
+    fprintf(outfile, " records\n\n");
+    fprintf(outfile, "Mean interarrival time%11.3f minutes\n\n",
+            mean_interarrival);
+    fprintf(outfile, "Mean service time%16.3f minutes\n\n", mean_service);
+    fprintf(outfile, "Number of customers%14d\n\n", num_delays_required);
+    fprintf(outfile, "Number of replications%11d\n\n", num_replications);
+    fprintf(outfile, "Customer record size%13d bytes\n\n",
+            (int) customer_pool.item_size);
+
+    for (i = 1; i <= num_replications; ++i) {
+
+        /* Initialize the simulation. */
+
+        initialize();
+
+        /* Run the simulation while more delays are still needed. */
+
+        while (num_custs_delayed < num_delays_required) {
+
+            /* Determine the next event. */
+
+            timing();
+
+            /* Update time-average statistical accumulators. */
+
+            update_time_avg_stats();
+
+            /* Invoke the appropriate event function, and return its node to
+               the pool. */
+
+            switch (current_event->type) {
+                case ARRIVAL:
+                    arrive();
+                    break;
+                case DEPARTURE:
+                    depart();
+                    break;
+            }
+            pool_free(&event_pool, current_event);
+        }
+
+        /* Invoke the report generator. */
+
+        report(i);
+    }
+
+    /* End the simulation. */
+
+    pool_destroy(&customer_pool);
+    pool_destroy(&event_pool);
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    /* Initialize the simulation clock. */
+
+    sim_time = 0.0;
+
+    /* Initialize the state variables.  Customers and events left over from
+       the previous replication are all returned to their pools at once. */
+
+    pool_reset(&customer_pool);
+    pool_reset(&event_pool);
+    server_status   = IDLE;
+    num_in_q        = 0;
+    queue_head      = NULL;
+    queue_tail      = NULL;
+    event_list      = NULL;
+    time_last_event = 0.0;
+
+    /* Initialize the statistical counters. */
+
+    num_arrivals       = 0;
+    num_custs_delayed  = 0;
+    total_of_delays    = 0.0;
+    area_num_in_q      = 0.0;
+    area_server_status = 0.0;
+
+    /* Initialize event list.  Since no customers are present, only the first
+       arrival is scheduled. */
+
+    schedule(sim_time + expon(mean_interarrival), ARRIVAL, NULL);
+}
+
+
+void schedule(float time, int type, struct customer *customer)  /* Event
+                                                      scheduling function. */
+{
+    struct event *e, **link;
+
+    e = pool_alloc(&event_pool);
+    if (e == NULL) {
+        fprintf(outfile, "\nOverflow of the event list at time %f", sim_time);
+        exit(2);
+    }
+    e->time     = time;
+    e->type     = type;
+    e->customer = customer;
+
+    /* Insert the event in time order, after any events at the same time. */
+
+    for (link = &event_list; *link != NULL && (*link)->time <= time;
+         link = &(*link)->next)
+        ;
+    e->next = *link;
+    *link   = e;
+}
+
+
+void timing(void)  /* Timing function. */
+{
+    /* Check to see whether the event list is empty. */
+
+    if (event_list == NULL) {
+
+        /* The event list is empty, so stop the simulation. */
+
+        fprintf(outfile, "\nEvent list empty at time %f", sim_time);
+        exit(1);
+    }
+
+    /* Remove the first event from the list, and advance the simulation
+       clock. */
+
+    current_event = event_list;
+    event_list    = current_event->next;
+    sim_time      = current_event->time;
+}
+
+
+void arrive(void)  /* Arrival event function. */
+{
+    struct customer *c;
+
+    /* Schedule next arrival. */
+
+    schedule(sim_time + expon(mean_interarrival), ARRIVAL, NULL);
+
+    /* Make a record for the arriving customer. */
+
+    c = pool_alloc(&customer_pool);
+    if (c == NULL) {
+
+        /* The queue has overflowed, so stop the simulation. */
+
+        fprintf(outfile, "\nOverflow of the customer pool at");
+        fprintf(outfile, " time %f", sim_time);
+        exit(2);
+    }
+    c->time_arrival = sim_time;
+    c->number       = ++num_arrivals;
+    c->next         = NULL;
+
+    /* Check to see whether server is busy. */
+
+    if (server_status == BUSY) {
+
+        /* Server is busy, so put the customer at the end of the queue. */
+
+        ++num_in_q;
+        if (queue_tail == NULL)
+            queue_head = c;
+        else
+            queue_tail->next = c;
+        queue_tail = c;
+    }
+
+    else {
+
+        /* Server is idle, so arriving customer has a delay of zero.  Increment
+           the number of customers delayed, make server busy, and schedule the
+           customer's departure. */
+
+        ++num_custs_delayed;
+        server_status = BUSY;
+        schedule(sim_time + expon(mean_service), DEPARTURE, c);
+    }
+}
+
+
+void depart(void)  /* Departure event function. */
+{
+    struct customer *c;
+
+    /* The departing customer's record is no longer needed. */
+
+    pool_free(&customer_pool, current_event->customer);
+
+    /* Check to see whether the queue is empty. */
+
+    if (num_in_q == 0) {
+
+        /* The queue is empty so make the server idle. */
+
+        server_status = IDLE;
+    }
+
+    else {
+
+        /* The queue is nonempty, so take the first customer off the queue,
+           compute the customer's delay and update the total delay
+           accumulator. */
+
+        --num_in_q;
+        c          = queue_head;
+        queue_head = c->next;
+        if (queue_head == NULL)
+            queue_tail = NULL;
+        total_of_delays += sim_time - c->time_arrival;
+
+        /* Increment the number of customers delayed, and schedule departure. */
+
+        ++num_custs_delayed;
+        schedule(sim_time + expon(mean_service), DEPARTURE, c);
+    }
+}
+
+
+void report(int replication)  /* Report generator function. */
+{
+    /* Compute and write estimates of desired measures of performance. */
+
+    fprintf(outfile, "\nReplication%22d\n\n", replication);
+    fprintf(outfile, "Average delay in queue%11.3f minutes\n\n",
+            total_of_delays / num_custs_delayed);
+    fprintf(outfile, "Average number in queue%10.3f\n\n",
+            area_num_in_q / sim_time);
+    fprintf(outfile, "Server utilization%15.3f\n\n",
+            area_server_status / sim_time);
+    fprintf(outfile, "Time simulation ended%12.3f minutes\n\n", sim_time);
+    fprintf(outfile, "Most customers in system%9ld\n\n",
+            customer_pool.peak_in_use);
+    customer_pool.peak_in_use = 0;
+}
+
+
+void update_time_avg_stats(void)  /* Update area accumulators for time-average
+                                     statistics. */
+{
+    float time_since_last_event;
+
+    /* Compute time since last event, and update last-event-time marker. */
+
+    time_since_last_event = sim_time - time_last_event;
+    time_last_event       = sim_time;
+
+    /* Update area under number-in-queue function. */
+
+    area_num_in_q      += num_in_q * time_since_last_event;
+
+    /* Update area under server-busy indicator function. */
+
+    area_server_status += server_status * time_since_last_event;
+}
+
+
+float expon(float mean)  /* Exponential variate generation function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrand(1));
+}
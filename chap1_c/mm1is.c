@@ -0,0 +1,138 @@
+/* External definitions for single-server queueing system, estimating tail
+   probabilities of the delay in queue by importance sampling. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+int    num_delays, num_samples;
+long   num_steps;
+float  mean_interarrival, mean_service, tilt, *delay;
+double lambda, mu, theta, log_ratio_per_customer;
+FILE   *infile, *outfile;
+
+double sample(float d);
+float  expon(float mean);
+
+
+int main()  /* Main function. */
+{
+    int    i, j;
+    double lr, sum, sum_sq, mean, std_error, rel_error, exact;
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm1is.in",  "r");
+    outfile = fopen("mm1is.out", "w");
+
+    /* Read input parameters: the tilt as a multiple of the optimal tilt
+       mu - lambda, the number of samples per delay, and the delays. */
+
+    fscanf(infile, "%f %f %f %d %d", &mean_interarrival, &mean_service, &tilt,
+           &num_samples, &num_delays);
+    delay = malloc(num_delays * sizeof(float));
+    for (j = 0; j < num_delays; ++j)
+        fscanf(infile, "%f", &delay[j]);
+
+    /* Tilting the service rate down by theta and the arrival rate up by
+       theta gives the random walk of successive delays a positive drift when
+       theta exceeds (mu - lambda) / 2, so every sample path crosses the
+       delay. */
+
+    lambda = 1.0 / mean_interarrival;
+    mu     = 1.0 / mean_service;
+    theta  = tilt * (mu - lambda);
+    if (lambda >= mu || theta <= 0.5 * (mu - lambda) || theta >= mu ||
+        num_samples < 2) {
+        fprintf(outfile, "\nNeed rho < 1, (mu - lambda) / 2 < tilt");
+        fprintf(outfile, " (mu - lambda) < mu, and 2 or more samples");
+        exit(1);
+    }
+    log_ratio_per_customer = log(mu * lambda / ((mu - theta) * (lambda + theta)));
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Single-server queueing system, delay tail by importance");
+    fprintf(outfile, " sampling\n\n");
+    fprintf(outfile, "Mean interarrival time%11.3f minutes\n\n",
+            mean_interarrival);
+    fprintf(outfile, "Mean service time%16.3f minutes\n\n", mean_service);
+    fprintf(outfile, "Tilted interarrival time%9.3f minutes\n\n",
+            1.0 / (lambda + theta));
+    fprintf(outfile, "Tilted service time%14.3f minutes\n\n",
+            1.0 / (mu - theta));
+    fprintf(outfile, "Samples per delay%16d\n\n", num_samples);
+    fprintf(outfile, "                            95%%       Relative");
+    fprintf(outfile, "                      Crude    Customers\n");
+    fprintf(outfile, "   Delay   P(delay > d)  half-width      error");
+    fprintf(outfile, "       Exact        samples   per sample\n");
+
+    for (j = 0; j < num_delays; ++j) {
+
+        /* Estimate P(delay > d) by the mean of the likelihood ratios of
+           independent samples. */
+
+        num_steps = 0;
+        sum       = 0.0;
+        sum_sq    = 0.0;
+        for (i = 0; i < num_samples; ++i) {
+            lr      = sample(delay[j]);
+            sum    += lr;
+            sum_sq += lr * lr;
+        }
+        mean      = sum / num_samples;
+        std_error = sqrt((sum_sq / num_samples - mean * mean) /
+                         (num_samples - 1));
+        rel_error = std_error / mean;
+
+        /* The exact steady-state value is rho exp(-(mu - lambda) d).  Crude
+           simulation needs (1 - p) / (p rel_error^2) delays for the same
+           relative error, before allowing for their correlation. */
+
+        exact = lambda / mu * exp(-(mu - lambda) * delay[j]);
+        fprintf(outfile, "%8.2f%15.4e%12.3e%11.4f%12.4e%15.3e%13.1f\n",
+                delay[j], mean, 1.96 * std_error, rel_error, exact,
+                (1.0 - mean) / (mean * rel_error * rel_error),
+                (double) num_steps / num_samples);
+    }
+
+    free(delay);
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+double sample(float d)  /* Return the likelihood ratio of one sample, whose
+                           mean over samples is P(delay > d). */
+{
+    float  x, a;
+    double s, log_lr;
+
+    /* By Lindley's recursion, the steady-state delay has the distribution of
+       the maximum of the random walk whose steps are a service time less an
+       interarrival time, so P(delay > d) is the probability that the walk
+       ever exceeds d.  Simulate the walk under the tilted rates until it
+       does, accumulating the log of the likelihood ratio of each customer's
+       service and interarrival times. */
+
+    s      = 0.0;
+    log_lr = 0.0;
+    do {
+        x       = expon(1.0 / (mu - theta));
+        a       = expon(1.0 / (lambda + theta));
+        s      += x - a;
+        log_lr += log_ratio_per_customer - theta * (x - a);
+        ++num_steps;
+    } while (s <= d);
+    return exp(log_lr);
+}
+
+
+float expon(float mean)  /* Exponential variate generation function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrand(1));
+}
@@ -0,0 +1,573 @@
+/* External definitions for multi-class single-server queueing system with
+   priority and shortest-processing-time disciplines. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "pool.h"     /* Header file for pool allocator. */
+
+#ifndef Q_LIMIT
+#define Q_LIMIT 100000  /* Limit on number of customers in queue. */
+#endif
+#define RING_SIZE    131072  /* Ring buffer size, a power of two above
+                                Q_LIMIT. */
+#define CLASS_LIMIT      10  /* Limit on number of customer classes. */
+#define BUSY              1  /* Mnemonics for server's being busy */
+#define IDLE              0  /* and idle. */
+#define FIFO              0  /* Queue disciplines: first in, first out, */
+#define NONPREEMPTIVE     1  /* non-preemptive priority (class 1 highest), */
+#define PREEMPTIVE        2  /* preemptive-resume priority, and */
+#define SPT               3  /* shortest processing time. */
+#define STREAM_INTERARRIVAL 1  /* Random-number streams for interarrival */
+#define STREAM_CLASS        2  /* times, classes and service times, all */
+#define STREAM_SERVICE      3  /* drawn at arrival. */
+
+struct customer {  /* Customer record. */
+    float            time_arrival, time_preempted, service_remaining;
+    int              class, started;
+    long             number;
+    struct customer *child, *sibling;  /* Pairing heap links. */
+};
+
+struct ring {  /* Ring buffer of waiting customers. */
+    struct customer *items[RING_SIZE];
+    unsigned long    head, tail;
+};
+
+int   discipline, next_event_type, num_classes, num_custs_delayed,
+      num_delays_required, num_events, num_in_q, num_in_q_class[CLASS_LIMIT + 1],
+      num_served[CLASS_LIMIT + 1], num_delayed[CLASS_LIMIT + 1],
+      num_preemptions, server_status;
+long  num_arrivals;
+float area_num_in_q[CLASS_LIMIT + 1], area_server_status, mean_interarrival,
+      mean_service[CLASS_LIMIT + 1], prob_distrib_class[CLASS_LIMIT + 1],
+      sim_time, time_last_event, time_next_event[3],
+      total_of_delays[CLASS_LIMIT + 1], total_in_system[CLASS_LIMIT + 1];
+struct ring      rings[CLASS_LIMIT + 1];
+struct customer *heap, *in_service;
+struct pool      customer_pool;
+FILE  *infile, *outfile;
+
+void  initialize(void);
+void  timing(void);
+void  arrive(void);
+void  depart(void);
+void  start_service(struct customer *c);
+void  enqueue(struct customer *c);
+struct customer *dequeue(void);
+void  ring_push(struct ring *r, struct customer *c);
+void  ring_push_front(struct ring *r, struct customer *c);
+struct customer *ring_pop(struct ring *r);
+struct customer *heap_merge(struct customer *a, struct customer *b);
+struct customer *heap_pop(void);
+void  report(void);
+void  update_time_avg_stats(void);
+float expon(float mean, int stream);
+int   random_integer(float prob_distrib[], int stream);
+
+
+int main()  /* Main function. */
+{
+    int   k;
+    float prob;
+    static const char *names[] = { "FIFO", "Non-preemptive priority",
+                                   "Preemptive-resume priority",
+                                   "Shortest processing time" };
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm1pri.in",  "r");
+    outfile = fopen("mm1pri.out", "w");
+
+    /* Specify the number of events for the timing function. */
+
+    num_events = 2;
+
+    /* Read input parameters: the discipline, the number of classes, the
+       number of customers, the mean interarrival time, and for each class its
+       probability and mean service time.  Class 1 has the highest
+       priority. */
+
+    fscanf(infile, "%d %d %d %f", &discipline, &num_classes,
+           &num_delays_required, &mean_interarrival);
+    if (discipline < FIFO || discipline > SPT || num_classes < 1 ||
+        num_classes > CLASS_LIMIT) {
+        fprintf(outfile, "\nInvalid discipline or number of classes");
+        exit(1);
+    }
+    prob = 0.0;
+    for (k = 1; k <= num_classes; ++k) {
+        fscanf(infile, "%f %f", &prob_distrib_class[k], &mean_service[k]);
+        prob += prob_distrib_class[k];
+        prob_distrib_class[k] = prob;  /* Cumulative, for random_integer. */
+    }
+    prob_distrib_class[num_classes] = 1.0;
+
+    if (pool_init(&customer_pool, sizeof(struct customer), Q_LIMIT + 1)
+        != 0) {
+        fprintf(outfile, "\nCannot allocate the customer pool");
+        exit(3);
+    }
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Multi-class single-server queueing system\n\n");
+    fprintf(outfile, "Discipline%35s\n\n", names[discipline]);
+    fprintf(outfile, "Mean interarrival time%11.3f minutes\n\n",
+            mean_interarrival);
+    fprintf(outfile, "Number of customers%14d\n\n", num_delays_required);
+    fprintf(outfile, "Class   Probability   Mean service\n");
+    for (k = 1; k <= num_classes; ++k)
+        fprintf(outfile, "%5d%14.3f%15.3f\n", k, prob_distrib_class[k] -
+                (k > 1 ? prob_distrib_class[k - 1] : 0.0), mean_service[k]);
+
+    /* Initialize the simulation. */
+
+    initialize();
+
+    /* Run the simulation while more delays are still needed. */
+
+    while (num_custs_delayed < num_delays_required) {
+
+        /* Determine the next event. */
+
+        timing();
+
+        /* Update time-average statistical accumulators. */
+
+        update_time_avg_stats();
+
+        /* Invoke the appropriate event function. */
+
+        switch (next_event_type) {
+            case 1:
+                arrive();
+                break;
+            case 2:
+                depart();
+                break;
+        }
+    }
+
+    /* Invoke the report generator and end the simulation. */
+
+    report();
+
+    pool_destroy(&customer_pool);
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    int k;
+
+    /* Initialize the simulation clock. */
+
+    sim_time = 0.0;
+
+    /* Initialize the state variables. */
+
+    pool_reset(&customer_pool);
+    server_status   = IDLE;
+    in_service      = NULL;
+    heap            = NULL;
+    num_in_q        = 0;
+    time_last_event = 0.0;
+    for (k = 1; k <= num_classes; ++k) {
+        rings[k].head     = 0;
+        rings[k].tail     = 0;
+        num_in_q_class[k] = 0;
+    }
+
+    /* Initialize the statistical counters. */
+
+    num_arrivals       = 0;
+    num_custs_delayed  = 0;
+    num_preemptions    = 0;
+    area_server_status = 0.0;
+    for (k = 1; k <= num_classes; ++k) {
+        num_delayed[k]     = 0;
+        num_served[k]      = 0;
+        total_of_delays[k] = 0.0;
+        total_in_system[k] = 0.0;
+        area_num_in_q[k]   = 0.0;
+    }
+
+    /* Initialize event list.  Since no customers are present, the departure
+       (service completion) event is eliminated from consideration. */
+
+    time_next_event[1] = sim_time + expon(mean_interarrival,
+                                          STREAM_INTERARRIVAL);
+    time_next_event[2] = 1.0e+30;
+}
+
+
+void timing(void)  /* Timing function. */
+{
+    int   i;
+    float min_time_next_event = 1.0e+29;
+
+    next_event_type = 0;
+
+    /* Determine the event type of the next event to occur. */
+
+    for (i = 1; i <= num_events; ++i)
+        if (time_next_event[i] < min_time_next_event) {
+            min_time_next_event = time_next_event[i];
+            next_event_type     = i;
+        }
+
+    /* Check to see whether the event list is empty. */
+
+    if (next_event_type == 0) {
+
+        /* The event list is empty, so stop the simulation. */
+
+        fprintf(outfile, "\nEvent list empty at time %f", sim_time);
+        exit(1);
+    }
+
+    /* The event list is not empty, so advance the simulation clock. */
+
+    sim_time = min_time_next_event;
+}
+
+
+void arrive(void)  /* Arrival event function. */
+{
+    struct customer *c;
+
+    /* Schedule next arrival. */
+
+    time_next_event[1] = sim_time + expon(mean_interarrival,
+                                          STREAM_INTERARRIVAL);
+
+    /* Make a record for the arriving customer, with its class and service
+       time. */
+
+    c = pool_alloc(&customer_pool);
+    if (c == NULL) {
+
+        /* The queue has overflowed, so stop the simulation. */
+
+        fprintf(outfile, "\nOverflow of the customer pool at");
+        fprintf(outfile, " time %f", sim_time);
+        exit(2);
+    }
+    c->time_arrival      = sim_time;
+    c->class             = random_integer(prob_distrib_class, STREAM_CLASS);
+    c->service_remaining = expon(mean_service[c->class], STREAM_SERVICE);
+    c->started           = 0;
+    c->number            = ++num_arrivals;
+
+    /* Start the customer's service if the server is idle.  Under preemptive
+       priority, a customer of higher priority than the one in service
+       preempts it; the preempted customer keeps its remaining service time
+       and goes back to the front of its class's queue, where it waits again
+       from now. */
+
+    if (server_status == IDLE)
+        start_service(c);
+    else if (discipline == PREEMPTIVE && c->class < in_service->class) {
+        in_service->service_remaining = time_next_event[2] - sim_time;
+        in_service->time_preempted    = sim_time;
+        ring_push_front(&rings[in_service->class], in_service);
+        ++num_in_q_class[in_service->class];
+        ++num_in_q;
+        ++num_preemptions;
+        start_service(c);
+    }
+    else
+        enqueue(c);
+}
+
+
+void depart(void)  /* Departure event function. */
+{
+    struct customer *c;
+
+    /* Record the departing customer's time in system, and return its record
+       to the pool. */
+
+    ++num_served[in_service->class];
+    total_in_system[in_service->class] += sim_time - in_service->time_arrival;
+    pool_free(&customer_pool, in_service);
+    in_service = NULL;
+
+    /* Check to see whether the queue is empty. */
+
+    if (num_in_q == 0) {
+
+        /* The queue is empty so make the server idle and eliminate the
+           departure (service completion) event from consideration. */
+
+        server_status      = IDLE;
+        time_next_event[2] = 1.0e+30;
+    }
+
+    else {
+
+        /* The queue is nonempty, so start the service of the customer chosen
+           by the discipline. */
+
+        c = dequeue();
+        start_service(c);
+    }
+}
+
+
+void start_service(struct customer *c)  /* Begin or resume the service of
+                                           customer c. */
+{
+    /* A customer is counted as delayed when its service first begins, but
+       its delay in queue also includes the time it waits after each
+       preemption, so that the average delay agrees with the average number
+       in queue (which counts preempted customers) by Little's law. */
+
+    if (!c->started) {
+        c->started = 1;
+        ++num_delayed[c->class];
+        ++num_custs_delayed;
+        total_of_delays[c->class] += sim_time - c->time_arrival;
+    }
+    else
+        total_of_delays[c->class] += sim_time - c->time_preempted;
+    in_service         = c;
+    server_status      = BUSY;
+    time_next_event[2] = sim_time + c->service_remaining;
+}
+
+
+void enqueue(struct customer *c)  /* Put customer c in queue. */
+{
+    if (num_in_q == Q_LIMIT) {
+
+        /* The queue has overflowed, so stop the simulation. */
+
+        fprintf(outfile, "\nOverflow of the queue at time %f", sim_time);
+        exit(2);
+    }
+    ++num_in_q;
+    ++num_in_q_class[c->class];
+
+    /* FIFO keeps all customers in one ring, the priority disciplines keep a
+       ring per class, and SPT keeps a pairing heap on service time. */
+
+    switch (discipline) {
+        case FIFO:
+            ring_push(&rings[1], c);
+            break;
+        case NONPREEMPTIVE:
+        case PREEMPTIVE:
+            ring_push(&rings[c->class], c);
+            break;
+        case SPT:
+            c->child   = NULL;
+            c->sibling = NULL;
+            heap       = heap_merge(heap, c);
+            break;
+    }
+}
+
+
+struct customer *dequeue(void)  /* Take the next customer out of queue. */
+{
+    int              k;
+    struct customer *c = NULL;
+
+    switch (discipline) {
+        case FIFO:
+            c = ring_pop(&rings[1]);
+            break;
+        case NONPREEMPTIVE:
+        case PREEMPTIVE:
+
+            /* Serve the first customer of the highest-priority class with
+               customers waiting. */
+
+            for (k = 1; rings[k].head == rings[k].tail; ++k)
+                ;
+            c = ring_pop(&rings[k]);
+            break;
+        case SPT:
+            c = heap_pop();
+            break;
+    }
+    --num_in_q;
+    --num_in_q_class[c->class];
+    return c;
+}
+
+
+void ring_push(struct ring *r, struct customer *c)  /* Append c to ring r. */
+{
+    r->items[r->tail++ & (RING_SIZE - 1)] = c;
+}
+
+
+void ring_push_front(struct ring *r, struct customer *c)  /* Put c at the front
+                                                             of ring r. */
+{
+    if (r->tail - r->head == RING_SIZE) {
+        fprintf(outfile, "\nOverflow of the queue at time %f", sim_time);
+        exit(2);
+    }
+    r->items[--r->head & (RING_SIZE - 1)] = c;
+}
+
+
+struct customer *ring_pop(struct ring *r)  /* Remove the first customer of
+                                              ring r. */
+{
+    return r->items[r->head++ & (RING_SIZE - 1)];
+}
+
+
+struct customer *heap_merge(struct customer *a, struct customer *b)  /* Merge
+                                                          two pairing heaps. */
+{
+    struct customer *t;
+
+    if (a == NULL)
+        return b;
+    if (b == NULL)
+        return a;
+
+    /* The root with the shorter service time (and, on a tie, the earlier
+       arrival) becomes the parent of the other. */
+
+    if (b->service_remaining < a->service_remaining ||
+        (b->service_remaining == a->service_remaining &&
+         b->number < a->number)) {
+        t = a;
+        a = b;
+        b = t;
+    }
+    b->sibling = a->child;
+    a->child   = b;
+    return a;
+}
+
+
+struct customer *heap_pop(void)  /* Remove the customer with the shortest
+                                    service time from the pairing heap. */
+{
+    struct customer *root, *a, *b, *next, *pairs;
+
+    root = heap;
+
+    /* Merge the children of the root in pairs from left to right, and then
+       merge the pairs from right to left (the two-pass method), which gives
+       O(log n) amortized time. */
+
+    pairs = NULL;
+    for (a = root->child; a != NULL; a = next) {
+        b = a->sibling;
+        if (b == NULL) {
+            next = NULL;
+            a->sibling = pairs;
+            pairs      = a;
+            break;
+        }
+        next       = b->sibling;
+        a->sibling = NULL;
+        b->sibling = NULL;
+        a          = heap_merge(a, b);
+        a->sibling = pairs;
+        pairs      = a;
+    }
+    heap = NULL;
+    for (a = pairs; a != NULL; a = next) {
+        next       = a->sibling;
+        a->sibling = NULL;
+        heap       = heap_merge(heap, a);
+    }
+    return root;
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    int   k, n;
+    float total_delays, total_system;
+
+    /* Compute and write estimates of desired measures of performance, by
+       class and overall. */
+
+    fprintf(outfile, "\n\n        Customers    Average delay    Average time");
+    fprintf(outfile, "    Average number\n");
+    fprintf(outfile, "Class     delayed         in queue       in system");
+    fprintf(outfile, "          in queue\n");
+    n            = 0;
+    total_delays = 0.0;
+    total_system = 0.0;
+    for (k = 1; k <= num_classes; ++k) {
+        fprintf(outfile, "\n%5d%12d%17.3f%16.3f%18.3f", k, num_delayed[k],
+                total_of_delays[k] / num_delayed[k],
+                total_in_system[k] / num_served[k],
+                area_num_in_q[k] / sim_time);
+        n            += num_served[k];
+        total_delays += total_of_delays[k];
+        total_system += total_in_system[k];
+    }
+    fprintf(outfile, "\n  All%12d%17.3f%16.3f\n\n", num_custs_delayed,
+            total_delays / num_custs_delayed, total_system / n);
+    fprintf(outfile, "Server utilization%15.3f\n\n",
+            area_server_status / sim_time);
+    fprintf(outfile, "Number of preemptions%12d\n\n", num_preemptions);
+    fprintf(outfile, "Time simulation ended%12.3f minutes", sim_time);
+}
+
+
+void update_time_avg_stats(void)  /* Update area accumulators for time-average
+                                     statistics. */
+{
+    int   k;
+    float time_since_last_event;
+
+    /* Compute time since last event, and update last-event-time marker. */
+
+    time_since_last_event = sim_time - time_last_event;
+    time_last_event       = sim_time;
+
+    /* Update areas under number-in-queue functions. */
+
+    for (k = 1; k <= num_classes; ++k)
+        area_num_in_q[k] += num_in_q_class[k] * time_since_last_event;
+
+    /* Update area under server-busy indicator function. */
+
+    area_server_status += server_status * time_since_last_event;
+}
+
+
+float expon(float mean, int stream)  /* Exponential variate generation
+                                        function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrand(stream));
+}
+
+
+int random_integer(float prob_distrib[], int stream)  /* Random integer
+                                                         generation function. */
+{
+    int   i;
+    float u;
+
+    /* Generate a U(0,1) random variate. */
+
+    u = lcgrand(stream);
+
+    /* Return a random integer in accordance with the (cumulative)
+       distribution function prob_distrib. */
+
+    for (i = 1; u >= prob_distrib[i]; ++i)
+        ;
+    return i;
+}
@@ -0,0 +1,378 @@
+/* External definitions for single-server queueing system, steady-state
+   estimation by the regenerative method with cycles simulated in parallel. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+#define RING_SIZE        65536  /* Queue ring size, a power of two. */
+#define BUSY                 1  /* Mnemonics for server's being busy */
+#define IDLE                 0  /* and idle. */
+#define THREAD_LIMIT       256  /* Limit on number of worker threads. */
+#define SUBSTREAM_LENGTH (1L << 22)  /* Random numbers reserved per batch. */
+#define MODLUS      2147483647  /* Modulus of lcgrand. */
+
+struct sums {  /* Sums over the cycles of a batch of the per-cycle delay
+                  total Y, customers N, queue area A, busy time B and length
+                  T, and of the products needed for the ratio variances. */
+    double y, n, a, b, t, yy, yn, nn, aa, at, bb, bt, tt;
+    long   cycles, randoms;
+};
+
+struct system {  /* State of one simulation of the system. */
+    int   next_event_type, num_in_q, server_status;
+    unsigned long q_head, q_tail;
+    float area_num_in_q, area_server_status, sim_time, time_last_event,
+          time_next_event[3], total_of_delays, time_arrival[RING_SIZE];
+    long  num_custs_delayed, z, randoms;
+};
+
+int   cycles_per_batch, next_batch, num_batches, num_threads;
+long  *batch_seed;
+float mean_interarrival, mean_service;
+struct sums *batch;
+FILE  *infile, *outfile;
+
+void  *worker(void *arg);
+void   run_batch(int k, struct system *sys);
+void   cycle(struct system *sys);
+void   timing(struct system *sys);
+void   arrive(struct system *sys);
+void   depart(struct system *sys);
+void   update_time_avg_stats(struct system *sys);
+void   report(void);
+void   ratio(FILE *f, const char *label, double sy, double sx, double syy,
+             double sxy, double sxx, long n, double exact);
+float  expon(float mean, struct system *sys);
+
+
+int main()  /* Main function. */
+{
+    int       i, num_started;
+    long      step;
+    pthread_t threads[THREAD_LIMIT];
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm1regen.in",  "r");
+    outfile = fopen("mm1regen.out", "w");
+
+    /* Read input parameters: the number of batches of cycles, the cycles per
+       batch, and the number of worker threads (0 means one per online
+       processor). */
+
+    fscanf(infile, "%f %f %d %d %d", &mean_interarrival, &mean_service,
+           &num_batches, &cycles_per_batch, &num_threads);
+    if (num_threads <= 0)
+        num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_threads > THREAD_LIMIT)
+        num_threads = THREAD_LIMIT;
+    if (num_batches < 1 || cycles_per_batch < 1 ||
+        num_batches > (MODLUS - 1) / SUBSTREAM_LENGTH) {
+        fprintf(outfile, "\nNumber of batches must be 1 to %ld",
+                (MODLUS - 1) / SUBSTREAM_LENGTH);
+        exit(1);
+    }
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Single-server queueing system, regenerative");
+    fprintf(outfile, " method\n\n");
+    fprintf(outfile, "Mean interarrival time%11.3f minutes\n\n",
+            mean_interarrival);
+    fprintf(outfile, "Mean service time%16.3f minutes\n\n", mean_service);
+    fprintf(outfile, "Number of batches%16d\n\n", num_batches);
+    fprintf(outfile, "Cycles per batch%17d\n\n", cycles_per_batch);
+    fprintf(outfile, "Number of threads%16d\n\n", num_threads);
+
+    /* Batch k draws its random numbers from the substream that starts
+       k * SUBSTREAM_LENGTH numbers into stream 1, so batches never share
+       random numbers, and the results do not depend on which thread runs
+       which batch or on the number of threads. */
+
+    batch      = calloc(num_batches, sizeof(struct sums));
+    batch_seed = malloc(num_batches * sizeof(long));
+    step       = lcgrandjp(1, SUBSTREAM_LENGTH);
+    batch_seed[0] = lcgrandgt(1);
+    for (i = 1; i < num_batches; ++i)
+        batch_seed[i] = (int64_t) batch_seed[i - 1] * step % MODLUS;
+
+    /* Run the batches on the pool of worker threads.  The workers claim
+       batches until none remain, so if not all the threads can be started,
+       those that were run all the batches. */
+
+    next_batch = 0;
+    for (num_started = 0; num_started < num_threads; ++num_started)
+        if (pthread_create(&threads[num_started], NULL, worker, NULL) != 0)
+            break;
+    if (num_started == 0) {
+        fprintf(outfile, "\nCannot start a worker thread");
+        exit(3);
+    }
+    if (num_started < num_threads)
+        fprintf(stderr, "Started only %d of %d worker threads\n", num_started,
+                num_threads);
+    for (i = 0; i < num_started; ++i)
+        pthread_join(threads[i], NULL);
+
+    /* Invoke the report generator and end the simulation. */
+
+    report();
+
+    free(batch);
+    free(batch_seed);
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+void *worker(void *arg)  /* Worker thread function.  Claims batches until
+                            none are left. */
+{
+    int            k;
+    struct system *sys;
+
+    (void) arg;
+    sys = malloc(sizeof(struct system));
+    while ((k = __sync_fetch_and_add(&next_batch, 1)) < num_batches)
+        run_batch(k, sys);
+    free(sys);
+    return NULL;
+}
+
+
+void run_batch(int k, struct system *sys)  /* Simulate the cycles of batch k
+                                              and accumulate their sums. */
+{
+    int          i;
+    double       y, n, a, b, t;
+    struct sums *s;
+
+    s          = &batch[k];
+    sys->z       = batch_seed[k];
+    sys->randoms = 0;
+    for (i = 0; i < cycles_per_batch; ++i) {
+        cycle(sys);
+        y = sys->total_of_delays;
+        n = sys->num_custs_delayed;
+        a = sys->area_num_in_q;
+        b = sys->area_server_status;
+        t = sys->sim_time;
+        s->y  += y;
+        s->n  += n;
+        s->a  += a;
+        s->b  += b;
+        s->t  += t;
+        s->yy += y * y;
+        s->yn += y * n;
+        s->nn += n * n;
+        s->aa += a * a;
+        s->at += a * t;
+        s->bb += b * b;
+        s->bt += b * t;
+        s->tt += t * t;
+    }
+    s->cycles  = cycles_per_batch;
+    s->randoms = sys->randoms;
+}
+
+
+void cycle(struct system *sys)  /* Simulate one regeneration cycle. */
+{
+    /* A cycle starts when a customer arrives to an empty system, and ends
+       just before the next customer to do so.  The clock and accumulators
+       start again from zero in every cycle, which keeps the float times
+       small. */
+
+    sys->sim_time           = 0.0;
+    sys->time_last_event    = 0.0;
+    sys->num_in_q           = 0;
+    sys->q_head             = 0;
+    sys->q_tail             = 0;
+    sys->server_status      = IDLE;
+    sys->num_custs_delayed  = 0;
+    sys->total_of_delays    = 0.0;
+    sys->area_num_in_q      = 0.0;
+    sys->area_server_status = 0.0;
+    arrive(sys);
+
+    for (;;) {
+
+        /* Determine the next event, and stop at an arrival to an empty
+           system, which starts the next cycle. */
+
+        timing(sys);
+        update_time_avg_stats(sys);
+        if (sys->next_event_type == 1) {
+            if (sys->server_status == IDLE)
+                return;
+            arrive(sys);
+        }
+        else
+            depart(sys);
+    }
+}
+
+
+void timing(struct system *sys)  /* Timing function. */
+{
+    sys->next_event_type =
+        sys->time_next_event[1] <= sys->time_next_event[2] ? 1 : 2;
+    sys->sim_time = sys->time_next_event[sys->next_event_type];
+}
+
+
+void arrive(struct system *sys)  /* Arrival event function. */
+{
+    /* Schedule next arrival. */
+
+    sys->time_next_event[1] = sys->sim_time + expon(mean_interarrival, sys);
+
+    /* Check to see whether server is busy. */
+
+    if (sys->server_status == BUSY) {
+
+        /* Server is busy, so put the customer at the end of the queue. */
+
+        if (sys->num_in_q == RING_SIZE) {
+            fprintf(outfile, "\nOverflow of the array time_arrival at");
+            fprintf(outfile, " time %f", sys->sim_time);
+            exit(2);
+        }
+        ++sys->num_in_q;
+        sys->time_arrival[sys->q_tail++ & (RING_SIZE - 1)] = sys->sim_time;
+    }
+
+    else {
+
+        /* Server is idle, so arriving customer has a delay of zero. */
+
+        ++sys->num_custs_delayed;
+        sys->server_status      = BUSY;
+        sys->time_next_event[2] = sys->sim_time + expon(mean_service, sys);
+    }
+}
+
+
+void depart(struct system *sys)  /* Departure event function. */
+{
+    /* Check to see whether the queue is empty. */
+
+    if (sys->num_in_q == 0) {
+        sys->server_status      = IDLE;
+        sys->time_next_event[2] = 1.0e+30;
+    }
+
+    else {
+
+        /* The queue is nonempty, so the first customer in queue begins
+           service.  Update the total delay accumulator. */
+
+        --sys->num_in_q;
+        sys->total_of_delays +=
+            sys->sim_time - sys->time_arrival[sys->q_head++ & (RING_SIZE - 1)];
+        ++sys->num_custs_delayed;
+        sys->time_next_event[2] = sys->sim_time + expon(mean_service, sys);
+    }
+}
+
+
+void update_time_avg_stats(struct system *sys)  /* Update area accumulators
+                                                   for time-average
+                                                   statistics. */
+{
+    float time_since_last_event;
+
+    time_since_last_event = sys->sim_time - sys->time_last_event;
+    sys->time_last_event  = sys->sim_time;
+    sys->area_num_in_q      += sys->num_in_q * time_since_last_event;
+    sys->area_server_status += sys->server_status * time_since_last_event;
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    int         k;
+    long        randoms_max;
+    double      rho;
+    struct sums s;
+
+    /* Add up the batches in order, so that the sums do not depend on the
+       order in which the threads finished them. */
+
+    memset(&s, 0, sizeof(s));
+    randoms_max = 0;
+    for (k = 0; k < num_batches; ++k) {
+        s.y  += batch[k].y;
+        s.n  += batch[k].n;
+        s.a  += batch[k].a;
+        s.b  += batch[k].b;
+        s.t  += batch[k].t;
+        s.yy += batch[k].yy;
+        s.yn += batch[k].yn;
+        s.nn += batch[k].nn;
+        s.aa += batch[k].aa;
+        s.at += batch[k].at;
+        s.bb += batch[k].bb;
+        s.bt += batch[k].bt;
+        s.tt += batch[k].tt;
+        s.cycles += batch[k].cycles;
+        if (batch[k].randoms > randoms_max)
+            randoms_max = batch[k].randoms;
+    }
+
+    fprintf(outfile, "Number of cycles%17ld\n\n", s.cycles);
+    fprintf(outfile, "Mean cycle length%16.3f minutes\n\n", s.t / s.cycles);
+    fprintf(outfile, "Mean customers per cycle%9.3f\n\n", s.n / s.cycles);
+
+    /* Write the ratio estimates with their 95% confidence intervals, and the
+       exact steady-state values. */
+
+    rho = mean_service / mean_interarrival;
+    fprintf(outfile, "                              Estimate     95%%");
+    fprintf(outfile, " half-width      Exact\n");
+    ratio(outfile, "Average delay in queue", s.y, s.n, s.yy, s.yn, s.nn,
+          s.cycles, rho < 1.0 ? rho * mean_service / (1.0 - rho) : 0.0);
+    ratio(outfile, "Average number in queue", s.a, s.t, s.aa, s.at, s.tt,
+          s.cycles, rho < 1.0 ? rho * rho / (1.0 - rho) : 0.0);
+    ratio(outfile, "Server utilization", s.b, s.t, s.bb, s.bt, s.tt,
+          s.cycles, rho < 1.0 ? rho : 0.0);
+
+    if (randoms_max > SUBSTREAM_LENGTH)
+        fprintf(outfile, "\nWarning: a batch used %ld random numbers, more than"
+                " its substream of %ld\n", randoms_max, SUBSTREAM_LENGTH);
+}
+
+
+void ratio(FILE *f, const char *label, double sy, double sx, double syy,
+           double sxy, double sxx, long n, double exact)  /* Write the ratio
+                                                  estimate sum Y / sum X and
+                                                  its confidence interval. */
+{
+    double r, mean_x, var;
+
+    /* The estimate r = sum Y / sum X is asymptotically normal with variance
+       Var(Y - r X) / (n E[X]^2) over n i.i.d. cycles. */
+
+    r      = sy / sx;
+    mean_x = sx / n;
+    var    = (syy - 2.0 * r * sxy + r * r * sxx) / (n - 1);
+    fprintf(f, "%-26s%12.4f%14.4f%13.4f\n", label, r,
+            1.96 * sqrt(var / n) / mean_x, exact);
+}
+
+
+float expon(float mean, struct system *sys)  /* Exponential variate
+                                                generation function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    ++sys->randoms;
+    return -mean * log(lcgrandz(&sys->z));
+}
@@ -0,0 +1,319 @@
+/* External definitions for single-server queueing system, estimating the
+   probability that a busy period overflows a finite buffer by multilevel
+   splitting. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+#define BUSY      1  /* Mnemonics for server's being busy */
+#define IDLE      0  /* and idle. */
+
+struct state {  /* Model state, copied to clone a trial that reaches a
+                   level. */
+    int   num_in_q, server_status;
+    float sim_time, time_next_event[3];
+};
+
+int   next_event_type, num_in_q, server_status, buffer_size, num_levels,
+      effort, num_replications, *level;
+long  num_events_total;
+float mean_interarrival, mean_service, sim_time, time_next_event[3];
+struct state *entrance, *entrance_next;
+FILE  *infile, *outfile;
+
+void   initialize(void);
+int    run_trial(int target);
+void   timing(void);
+void   arrive(void);
+void   depart(void);
+double split(void);
+void   report(double *estimate);
+void   save_state(struct state *s);
+void   load_state(struct state *s);
+float  expon(float mean);
+
+
+int main()  /* Main function. */
+{
+    int     i;
+    double *estimate;
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm1split.in",  "r");
+    outfile = fopen("mm1split.out", "w");
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%f %f %d %d %d %d", &mean_interarrival, &mean_service,
+           &buffer_size, &num_levels, &effort, &num_replications);
+
+    /* Overflow is the queue's exceeding buffer_size, as in mm1.c with
+       Q_LIMIT equal to buffer_size, which is the number in system reaching
+       buffer_size + 2.  Place the levels evenly between the single customer
+       who starts a busy period and that number. */
+
+    if (num_levels < 1 || num_levels > buffer_size + 1 || effort < 1 ||
+        num_replications < 2) {
+        fprintf(outfile, "\nInvalid number of levels, effort, or");
+        fprintf(outfile, " replications");
+        exit(1);
+    }
+    level = malloc((num_levels + 1) * sizeof(int));
+    for (i = 0; i <= num_levels; ++i)
+        level[i] = 1 + (int) ceil((double) i * (buffer_size + 1) / num_levels);
+    entrance      = malloc(effort * sizeof(struct state));
+    entrance_next = malloc(effort * sizeof(struct state));
+    estimate      = malloc(num_replications * sizeof(double));
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Single-server queueing system, buffer overflow by");
+    fprintf(outfile, " splitting\n\n");
+    fprintf(outfile, "Mean interarrival time%11.3f minutes\n\n",
+            mean_interarrival);
+    fprintf(outfile, "Mean service time%16.3f minutes\n\n", mean_service);
+    fprintf(outfile, "Buffer size%22d\n\n", buffer_size);
+    fprintf(outfile, "Levels (number in system)");
+    for (i = 1; i <= num_levels; ++i)
+        fprintf(outfile, "%s%4d", i % 10 == 1 && i > 1 ? "\n" : "", level[i]);
+    fprintf(outfile, "\n\nTrials per level%17d\n\n", effort);
+    fprintf(outfile, "Number of replications%11d\n\n", num_replications);
+
+    /* Run independent replications of the splitting procedure. */
+
+    num_events_total = 0;
+    for (i = 0; i < num_replications; ++i)
+        estimate[i] = split();
+
+    /* Invoke the report generator and end the simulation. */
+
+    report(estimate);
+
+    free(level);
+    free(entrance);
+    free(entrance_next);
+    free(estimate);
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+double split(void)  /* Return one fixed-effort splitting estimate of the
+                       overflow probability. */
+{
+    int           i, k, num_entrance, num_next;
+    double        p;
+    struct state *swap;
+
+    num_entrance = 0;
+    p            = 1.0;
+
+    for (k = 1; k <= num_levels; ++k) {
+
+        /* Start effort trials from the entrance states of the previous level,
+           taken in turn, or from the start of a new busy period for the first
+           level, and keep the state of each trial that reaches this level
+           before the system empties. */
+
+        num_next = 0;
+        for (i = 0; i < effort; ++i) {
+            if (k == 1)
+                initialize();
+            else
+                load_state(&entrance[i % num_entrance]);
+            if (run_trial(level[k]))
+                save_state(&entrance_next[num_next++]);
+        }
+
+        /* The estimate is the product of the fractions of trials reaching
+           each level. */
+
+        p *= (double) num_next / effort;
+        if (num_next == 0)
+            break;
+        swap          = entrance;
+        entrance      = entrance_next;
+        entrance_next = swap;
+        num_entrance  = num_next;
+    }
+    return p;
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    /* Initialize the simulation clock. */
+
+    sim_time = 0.0;
+
+    /* A customer has just arrived to an empty system and begun service. */
+
+    server_status = BUSY;
+    num_in_q      = 0;
+
+    /* Initialize event list with the next arrival and the first departure. */
+
+    time_next_event[1] = sim_time + expon(mean_interarrival);
+    time_next_event[2] = sim_time + expon(mean_service);
+}
+
+
+int run_trial(int target)  /* Return 1 if the number in system reaches
+                              target before the system empties, or 0. */
+{
+    for (;;) {
+
+        /* Determine and invoke the next event. */
+
+        timing();
+        ++num_events_total;
+        switch (next_event_type) {
+            case 1:
+                arrive();
+                if (num_in_q + server_status >= target)
+                    return 1;
+                break;
+            case 2:
+                depart();
+                if (server_status == IDLE)
+                    return 0;
+                break;
+        }
+    }
+}
+
+
+void timing(void)  /* Timing function. */
+{
+    /* Determine the event type of the next event to occur, and advance the
+       simulation clock. */
+
+    next_event_type = time_next_event[1] <= time_next_event[2] ? 1 : 2;
+    sim_time        = time_next_event[next_event_type];
+}
+
+
+void arrive(void)  /* Arrival event function. */
+{
+    /* Schedule next arrival. */
+
+    time_next_event[1] = sim_time + expon(mean_interarrival);
+
+    /* Check to see whether server is busy. */
+
+    if (server_status == BUSY)
+        ++num_in_q;
+    else {
+
+        /* Server is idle, so make it busy and schedule a departure. */
+
+        server_status      = BUSY;
+        time_next_event[2] = sim_time + expon(mean_service);
+    }
+}
+
+
+void depart(void)  /* Departure event function. */
+{
+    /* Check to see whether the queue is empty. */
+
+    if (num_in_q == 0) {
+
+        /* The queue is empty so make the server idle and eliminate the
+           departure (service completion) event from consideration. */
+
+        server_status      = IDLE;
+        time_next_event[2] = 1.0e+30;
+    }
+
+    else {
+
+        /* The queue is nonempty, so the next customer begins service. */
+
+        --num_in_q;
+        time_next_event[2] = sim_time + expon(mean_service);
+    }
+}
+
+
+void report(double *estimate)  /* Report generator function. */
+{
+    int    i;
+    double mean, s2, diff, std_error, rel_error, r, exact, cycle;
+
+    /* Compute the mean of the replication estimates and its standard
+       error. */
+
+    mean = 0.0;
+    for (i = 0; i < num_replications; ++i)
+        mean += estimate[i];
+    mean /= num_replications;
+    s2 = 0.0;
+    for (i = 0; i < num_replications; ++i) {
+        diff = estimate[i] - mean;
+        s2  += diff * diff;
+    }
+    s2       /= num_replications - 1;
+    std_error = sqrt(s2 / num_replications);
+    rel_error = mean > 0.0 ? std_error / mean : 0.0;
+
+    /* The number in system moves up with probability lambda / (lambda + mu)
+       at each event of a busy period, so the exact probability of reaching
+       buffer_size + 2 before 0 from 1 is the gambler's-ruin probability.  A
+       cycle of an idle and a busy period has mean 1 / (lambda (1 - rho)). */
+
+    r     = (double) mean_interarrival / mean_service;
+    exact = r == 1.0 ? 1.0 / (buffer_size + 2) :
+            (1.0 - r) / (1.0 - pow(r, buffer_size + 2));
+    cycle = r > 1.0 ? mean_interarrival / (1.0 - 1.0 / r) : 0.0;
+
+    fprintf(outfile, "\nProbability a busy period overflows%14.4e +/-%11.4e",
+            mean, 1.96 * std_error);
+    fprintf(outfile, "\n\nRelative error%35.4f\n\n", rel_error);
+    fprintf(outfile, "Exact probability%32.4e\n\n", exact);
+    if (cycle > 0.0 && mean > 0.0)
+        fprintf(outfile, "Mean time between overflows%22.4e minutes\n\n",
+                cycle / mean);
+
+    /* Compare the events simulated with those of crude simulation for the
+       same relative error, which needs (1 - p) / (p rel_error^2) busy periods
+       of 2 / (1 - rho) events each on average. */
+
+    fprintf(outfile, "Events simulated%33.4e\n\n", (double) num_events_total);
+    if (rel_error > 0.0 && r > 1.0)
+        fprintf(outfile, "Crude simulation would need%22.4e events\n",
+                (1.0 - mean) / (mean * rel_error * rel_error) *
+                2.0 / (1.0 - 1.0 / r));
+}
+
+
+void save_state(struct state *s)  /* Save the model state. */
+{
+    s->num_in_q           = num_in_q;
+    s->server_status      = server_status;
+    s->sim_time           = sim_time;
+    s->time_next_event[1] = time_next_event[1];
+    s->time_next_event[2] = time_next_event[2];
+}
+
+
+void load_state(struct state *s)  /* Restore the model state. */
+{
+    num_in_q           = s->num_in_q;
+    server_status      = s->server_status;
+    sim_time           = s->sim_time;
+    time_next_event[1] = s->time_next_event[1];
+    time_next_event[2] = s->time_next_event[2];
+}
+
+
+float expon(float mean)  /* Exponential variate generation function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrand(1));
+}
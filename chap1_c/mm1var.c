@@ -0,0 +1,461 @@
+/* External definitions for single-server queueing system with variance
+   reduction (antithetic variates and control variates). */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+#define Q_LIMIT     100  /* Limit on queue length. */
+#define REP_LIMIT  1000  /* Limit on number of replications. */
+#define BUSY          1  /* Mnemonics for server's being busy */
+#define IDLE          0  /* and idle. */
+#define STREAM_ARRIVE 1  /* Random-number stream for interarrival times. */
+#define STREAM_SERVE  2  /* Random-number stream for service times. */
+
+int   antithetic, next_event_type, num_custs_delayed, num_delays_required,
+      num_events, num_in_q, num_interarrivals, num_reps, num_services,
+      server_status;
+float area_num_in_q, area_server_status, mean_interarrival, mean_service,
+      sim_time, time_arrival[Q_LIMIT + 1], time_last_event, time_next_event[3],
+      total_of_delays, total_of_interarrivals, total_of_services;
+float crude_delay[REP_LIMIT + 1], crude_interarrival[REP_LIMIT + 1],
+      crude_service[REP_LIMIT + 1], pair_delay[REP_LIMIT / 2 + 1];
+FILE  *infile, *outfile;
+
+void  initialize(void);
+void  timing(void);
+void  arrive(void);
+void  depart(void);
+float simulate(void);
+void  report(void);
+void  update_time_avg_stats(void);
+float expon(float mean, int stream);
+float t_critical(int df);
+
+
+int main()  /* Main function. */
+{
+    int  i;
+    long zset_arrive, zset_serve;
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm1var.in",  "r");
+    outfile = fopen("mm1var.out", "w");
+
+    /* Specify the number of events for the timing function. */
+
+    num_events = 2;
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%f %f %d %d", &mean_interarrival, &mean_service,
+           &num_delays_required, &num_reps);
+    if (num_reps > REP_LIMIT)
+        num_reps = REP_LIMIT;
+    num_reps -= num_reps % 2;
+
+    /* The control-variate estimator's variance has num_reps - 3 degrees of
+       freedom, and the antithetic one's num_reps / 2 - 1, so both need at
+       least 4 replications. */
+
+    if (num_reps < 4) {
+        fprintf(outfile, "\nNeed at least 4 replications");
+        exit(1);
+    }
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Single-server queueing system with variance");
+    fprintf(outfile, " reduction\n\n");
+    fprintf(outfile, "Mean interarrival time%11.3f minutes\n\n",
+            mean_interarrival);
+    fprintf(outfile, "Mean service time%16.3f minutes\n\n", mean_service);
+    fprintf(outfile, "Number of customers%14d\n\n", num_delays_required);
+    fprintf(outfile, "Number of replications%11d\n\n", num_reps);
+
+    /* Run num_reps independent replications for the crude estimator.  The
+       average interarrival and service times actually generated in each
+       replication are kept as control variates. */
+
+    antithetic = 0;
+    for (i = 1; i <= num_reps; ++i) {
+        crude_delay[i]        = simulate();
+        crude_interarrival[i] = total_of_interarrivals / num_interarrivals;
+        crude_service[i]      = total_of_services / num_services;
+    }
+
+    /* Run num_reps / 2 antithetic pairs, so that the antithetic estimator uses
+       the same number of replications as the crude one.  Both members of a
+       pair start from the same seeds; the second member uses 1 - U in place of
+       each U, which the separate arrival and service streams keep
+       synchronized. */
+
+    for (i = 1; i <= num_reps / 2; ++i) {
+        zset_arrive = lcgrandgt(STREAM_ARRIVE);
+        zset_serve  = lcgrandgt(STREAM_SERVE);
+        antithetic  = 0;
+        pair_delay[i] = simulate();
+        lcgrandst(zset_arrive, STREAM_ARRIVE);
+        lcgrandst(zset_serve,  STREAM_SERVE);
+        antithetic  = 1;
+        pair_delay[i] = (pair_delay[i] + simulate()) / 2.0;
+    }
+
+    /* Invoke the report generator and end the simulation. */
+
+    report();
+
+    fclose(infile);
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    /* Initialize the simulation clock. */
+
+    sim_time = 0.0;
+
+    /* Initialize the state variables. */
+
+    server_status   = IDLE;
+    num_in_q        = 0;
+    time_last_event = 0.0;
+
+    /* Initialize the statistical counters, including the sums of the generated
+       interarrival and service times used as control variates. */
+
+    num_custs_delayed      = 0;
+    total_of_delays        = 0.0;
+    area_num_in_q          = 0.0;
+    area_server_status     = 0.0;
+    num_interarrivals      = 0;
+    num_services           = 0;
+    total_of_interarrivals = 0.0;
+    total_of_services      = 0.0;
+
+    /* Initialize event list.  Since no customers are present, the departure
+       (service completion) event is eliminated from consideration. */
+
+    time_next_event[1] = sim_time + expon(mean_interarrival, STREAM_ARRIVE);
+    time_next_event[2] = 1.0e+30;
+}
+
+
+void timing(void)  /* Timing function. */
+{
+    int   i;
+    float min_time_next_event = 1.0e+29;
+
+    next_event_type = 0;
+
+    /* Determine the event type of the next event to occur. */
+
+    for (i = 1; i <= num_events; ++i)
+        if (time_next_event[i] < min_time_next_event) {
+            min_time_next_event = time_next_event[i];
+            next_event_type     = i;
+        }
+
+    /* Check to see whether the event list is empty. */
+
+    if (next_event_type == 0) {
+
+        /* The event list is empty, so stop the simulation. */
+
+        fprintf(outfile, "\nEvent list empty at time %f", sim_time);
+        exit(1);
+    }
+
+    /* The event list is not empty, so advance the simulation clock. */
+
+    sim_time = min_time_next_event;
+}
+
+
+void arrive(void)  /* Arrival event function. */
+{
+    float delay;
+
+    /* Schedule next arrival. */
+
+    time_next_event[1] = sim_time + expon(mean_interarrival, STREAM_ARRIVE);
+
+    /* Check to see whether server is busy. */
+
+    if (server_status == BUSY) {
+
+        /* Server is busy, so increment number of customers in queue. */
+
+        ++num_in_q;
+
+        /* Check to see whether an overflow condition exists. */
+
+        if (num_in_q > Q_LIMIT) {
+
+            /* The queue has overflowed, so stop the simulation. */
+
+            fprintf(outfile, "\nOverflow of the array time_arrival at");
+            fprintf(outfile, " time %f", sim_time);
+            exit(2);
+        }
+
+        /* There is still room in the queue, so store the time of arrival of the
+           arriving customer at the (new) end of time_arrival. */
+
+        time_arrival[num_in_q] = sim_time;
+    }
+
+    else {
+
+        /* Server is idle, so arriving customer has a delay of zero.  (The
+           following two statements are for program clarity and do not affect
+           the results of the simulation.) */
+
+        delay            = 0.0;
+        total_of_delays += delay;
+
+        /* Increment the number of customers delayed, and make server busy. */
+
+        ++num_custs_delayed;
+        server_status = BUSY;
+
+        /* Schedule a departure (service completion). */
+
+        time_next_event[2] = sim_time + expon(mean_service, STREAM_SERVE);
+    }
+}
+
+
+void depart(void)  /* Departure event function. */
+{
+    int   i;
+    float delay;
+
+    /* Check to see whether the queue is empty. */
+
+    if (num_in_q == 0) {
+
+        /* The queue is empty so make the server idle and eliminate the
+           departure (service completion) event from consideration. */
+
+        server_status      = IDLE;
+        time_next_event[2] = 1.0e+30;
+    }
+
+    else {
+
+        /* The queue is nonempty, so decrement the number of customers in
+           queue. */
+
+        --num_in_q;
+
+        /* Compute the delay of the customer who is beginning service and update
+           the total delay accumulator. */
+
+        delay            = sim_time - time_arrival[1];
+        total_of_delays += delay;
+
+        /* Increment the number of customers delayed, and schedule departure. */
+
+        ++num_custs_delayed;
+        time_next_event[2] = sim_time + expon(mean_service, STREAM_SERVE);
+
+        /* Move each customer in queue (if any) up one place. */
+
+        for (i = 1; i <= num_in_q; ++i)
+            time_arrival[i] = time_arrival[i + 1];
+    }
+}
+
+
+float simulate(void)  /* Replication function. */
+{
+    /* Initialize the simulation. */
+
+    initialize();
+
+    /* Run the simulation while more delays are still needed. */
+
+    while (num_custs_delayed < num_delays_required) {
+
+        /* Determine the next event. */
+
+        timing();
+
+        /* Update time-average statistical accumulators. */
+
+        update_time_avg_stats();
+
+        /* Invoke the appropriate event function. */
+
+        switch (next_event_type) {
+            case 1:
+                arrive();
+                break;
+            case 2:
+                depart();
+                break;
+        }
+    }
+
+    /* Return the average delay in queue for this replication. */
+
+    return total_of_delays / num_custs_delayed;
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    int    i, num_pairs;
+    double mean_a, mean_d, mean_s, s_aa, s_as, s_ss, s_ad, s_sd, s_dd, det,
+           beta_a, beta_s, resid, s_ee, mean_p, s_pp, var_crude, var_anti,
+           var_cv, est_cv, da, ds;
+
+    num_pairs = num_reps / 2;
+
+    /* Compute the sample means of the delays and of the two controls. */
+
+    mean_d = mean_a = mean_s = 0.0;
+    for (i = 1; i <= num_reps; ++i) {
+        mean_d += crude_delay[i];
+        mean_a += crude_interarrival[i];
+        mean_s += crude_service[i];
+    }
+    mean_d /= num_reps;
+    mean_a /= num_reps;
+    mean_s /= num_reps;
+
+    /* Compute the sample variances and covariances of the delays and the
+       controls. */
+
+    s_aa = s_as = s_ss = s_ad = s_sd = s_dd = 0.0;
+    for (i = 1; i <= num_reps; ++i) {
+        da    = crude_interarrival[i] - mean_a;
+        ds    = crude_service[i] - mean_s;
+        s_aa += da * da;
+        s_as += da * ds;
+        s_ss += ds * ds;
+        s_ad += da * (crude_delay[i] - mean_d);
+        s_sd += ds * (crude_delay[i] - mean_d);
+        s_dd += (crude_delay[i] - mean_d) * (crude_delay[i] - mean_d);
+    }
+
+    /* Crude estimator: variance of the mean of num_reps replications. */
+
+    var_crude = s_dd / (num_reps - 1) / num_reps;
+
+    /* Control-variate estimator: regress the delays on the two controls, whose
+       true means (mean_interarrival, mean_service) are known, and correct the
+       crude mean by the observed deviations of the controls. */
+
+    det    = s_aa * s_ss - s_as * s_as;
+    beta_a = (s_ss * s_ad - s_as * s_sd) / det;
+    beta_s = (s_aa * s_sd - s_as * s_ad) / det;
+    est_cv = mean_d - beta_a * (mean_a - mean_interarrival)
+                    - beta_s * (mean_s - mean_service);
+    s_ee   = 0.0;
+    for (i = 1; i <= num_reps; ++i) {
+        resid = (crude_delay[i] - mean_d)
+                - beta_a * (crude_interarrival[i] - mean_a)
+                - beta_s * (crude_service[i] - mean_s);
+        s_ee += resid * resid;
+    }
+    var_cv = s_ee / (num_reps - 3) / num_reps;
+
+    /* Antithetic estimator: variance of the mean of num_pairs pair averages. */
+
+    mean_p = 0.0;
+    for (i = 1; i <= num_pairs; ++i)
+        mean_p += pair_delay[i];
+    mean_p /= num_pairs;
+    s_pp = 0.0;
+    for (i = 1; i <= num_pairs; ++i)
+        s_pp += (pair_delay[i] - mean_p) * (pair_delay[i] - mean_p);
+    var_anti = s_pp / (num_pairs - 1) / num_pairs;
+
+    /* Write the three estimators.  The variance-reduction factor is the ratio
+       of the crude variance to the variance of each estimator at the same
+       number of replications. */
+
+    fprintf(outfile, "              Average delay       95%% c.i.");
+    fprintf(outfile, "     Variance\n");
+    fprintf(outfile, "  Estimator        in queue    half-length");
+    fprintf(outfile, "    reduction\n\n");
+    fprintf(outfile, "  Crude%20.3f%15.3f%13.3f\n\n", mean_d,
+            t_critical(num_reps - 1) * sqrt(var_crude), 1.0);
+    fprintf(outfile, "  Antithetic%15.3f%15.3f%13.3f\n\n", mean_p,
+            t_critical(num_pairs - 1) * sqrt(var_anti), var_crude / var_anti);
+    fprintf(outfile, "  Control variates%9.3f%15.3f%13.3f\n\n", est_cv,
+            t_critical(num_reps - 3) * sqrt(var_cv), var_crude / var_cv);
+    fprintf(outfile, "Control coefficients%13.3f%10.3f", beta_a, beta_s);
+}
+
+
+void update_time_avg_stats(void)  /* Update area accumulators for time-average
+                                     statistics. */
+{
+    float time_since_last_event;
+
+    /* Compute time since last event, and update last-event-time marker. */
+
+    time_since_last_event = sim_time - time_last_event;
+    time_last_event       = sim_time;
+
+    /* Update area under number-in-queue function. */
+
+    area_num_in_q      += num_in_q * time_since_last_event;
+
+    /* Update area under server-busy indicator function. */
+
+    area_server_status += server_status * time_since_last_event;
+}
+
+
+float expon(float mean, int stream)  /* Exponential variate generation
+                                        function. */
+{
+    float u, x;
+
+    /* Generate a U(0,1) random variate, replacing it by its antithetic
+       complement when the antithetic member of a pair is being run. */
+
+    u = lcgrand(stream);
+    if (antithetic)
+        u = 1.0 - u;
+
+    /* Return an exponential random variate with mean "mean", accumulating it
+       into the control-variate sums for its stream. */
+
+    x = -mean * log(u);
+    if (stream == STREAM_ARRIVE) {
+        total_of_interarrivals += x;
+        ++num_interarrivals;
+    }
+    else {
+        total_of_services += x;
+        ++num_services;
+    }
+    return x;
+}
+
+
+float t_critical(int df)  /* Two-sided 95% critical point of the t
+                             distribution with df degrees of freedom. */
+{
+    static float t_table[] =
+    {  0.000,
+      12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+       2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+       2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+    if (df < 1)
+        return 0.0;
+    if (df <= 30)
+        return t_table[df];
+    return 1.960 + 2.4 / df;
+}
@@ -0,0 +1,408 @@
+/* External definitions for multi-server (M/M/c) queueing system with a large
+   server pool. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+#ifndef Q_LIMIT
+#define Q_LIMIT 100000  /* Limit on queue length. */
+#endif
+#define RING_SIZE    131072  /* Queue ring size, a power of two above
+                                Q_LIMIT. */
+#define SERVER_LIMIT   4096  /* Limit on number of servers (64 words of 64
+                                bits). */
+
+int      next_event_type, num_custs_delayed, num_delays_required, num_in_q,
+         num_servers, num_busy, heap_size, heap[SERVER_LIMIT + 1];
+unsigned long q_head, q_tail;
+uint64_t idle_words[SERVER_LIMIT / 64], idle_summary;
+float    area_num_in_q, area_num_busy, busy_time[SERVER_LIMIT],
+         mean_interarrival, mean_service, sim_time, time_arrival[RING_SIZE],
+         time_busy_since[SERVER_LIMIT], time_completion[SERVER_LIMIT],
+         time_last_event, time_next_arrival, total_of_delays;
+FILE     *infile, *outfile;
+
+void  initialize(void);
+void  timing(void);
+void  arrive(void);
+void  depart(void);
+int   find_idle_server(void);
+void  set_idle(int server);
+void  set_busy(int server);
+void  start_service(int server);
+void  heap_push(int server);
+void  heap_pop(void);
+void  report(void);
+void  update_time_avg_stats(void);
+float expon(float mean);
+double erlang_c(int c, double a);
+
+
+int main()  /* Main function. */
+{
+    /* Open input and output files. */
+
+    infile  = fopen("mmc.in",  "r");
+    outfile = fopen("mmc.out", "w");
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%f %f %d %d", &mean_interarrival, &mean_service,
+           &num_servers, &num_delays_required);
+    if (num_servers < 1 || num_servers > SERVER_LIMIT) {
+        fprintf(outfile, "\nNumber of servers must be 1 to %d", SERVER_LIMIT);
+        exit(1);
+    }
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Multi-server queueing system\n\n");
+    fprintf(outfile, "Mean interarrival time%11.3f minutes\n\n",
+            mean_interarrival);
+    fprintf(outfile, "Mean service time%16.3f minutes\n\n", mean_service);
+    fprintf(outfile, "Number of servers%16d\n\n", num_servers);
+    fprintf(outfile, "Number of customers%14d\n\n", num_delays_required);
+
+    /* Initialize the simulation. */
+
+    initialize();
+
+    /* Run the simulation while more delays are still needed. */
+
+    while (num_custs_delayed < num_delays_required) {
+
+        /* Determine the next event. */
+
+        timing();
+
+        /* Update time-average statistical accumulators. */
+
+        update_time_avg_stats();
+
+        /* Invoke the appropriate event function. */
+
+        switch (next_event_type) {
+            case 1:
+                arrive();
+                break;
+            case 2:
+                depart();
+                break;
+        }
+    }
+
+    /* Invoke the report generator and end the simulation. */
+
+    report();
+
+    fclose(infile);
+    fclose(outfile);
+    return 0;
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    int i;
+
+    /* Initialize the simulation clock. */
+
+    sim_time = 0.0;
+
+    /* Initialize the state variables.  All servers are idle. */
+
+    num_in_q        = 0;
+    q_head          = 0;
+    q_tail          = 0;
+    num_busy        = 0;
+    heap_size       = 0;
+    time_last_event = 0.0;
+    idle_summary    = 0;
+    for (i = 0; i < SERVER_LIMIT / 64; ++i)
+        idle_words[i] = 0;
+    for (i = 0; i < num_servers; ++i) {
+        set_idle(i);
+        busy_time[i] = 0.0;
+    }
+
+    /* Initialize the statistical counters. */
+
+    num_custs_delayed = 0;
+    total_of_delays   = 0.0;
+    area_num_in_q     = 0.0;
+    area_num_busy     = 0.0;
+
+    /* Initialize event list.  Since no customers are present, there are no
+       service completions. */
+
+    time_next_arrival = sim_time + expon(mean_interarrival);
+}
+
+
+void timing(void)  /* Timing function. */
+{
+    /* The next event is the next arrival or the earliest service completion,
+       which is at the top of the completion heap. */
+
+    if (heap_size > 0 && time_completion[heap[1]] < time_next_arrival) {
+        next_event_type = 2;
+        sim_time        = time_completion[heap[1]];
+    }
+    else {
+        next_event_type = 1;
+        sim_time        = time_next_arrival;
+    }
+}
+
+
+void arrive(void)  /* Arrival event function. */
+{
+    int server;
+
+    /* Schedule next arrival. */
+
+    time_next_arrival = sim_time + expon(mean_interarrival);
+
+    /* Check to see whether all servers are busy. */
+
+    server = find_idle_server();
+    if (server < 0) {
+
+        /* All servers are busy, so put the customer at the end of the
+           queue. */
+
+        if (num_in_q == Q_LIMIT) {
+
+            /* The queue has overflowed, so stop the simulation. */
+
+            fprintf(outfile, "\nOverflow of the array time_arrival at");
+            fprintf(outfile, " time %f", sim_time);
+            exit(2);
+        }
+        ++num_in_q;
+        time_arrival[q_tail++ & (RING_SIZE - 1)] = sim_time;
+    }
+
+    else {
+
+        /* A server is idle, so arriving customer has a delay of zero.
+           Increment the number of customers delayed, and start service. */
+
+        ++num_custs_delayed;
+        start_service(server);
+    }
+}
+
+
+void depart(void)  /* Departure event function. */
+{
+    int server;
+
+    /* Take the server completing service off the heap. */
+
+    server = heap[1];
+    heap_pop();
+
+    /* Check to see whether the queue is empty. */
+
+    if (num_in_q == 0) {
+
+        /* The queue is empty, so make the server idle and add its busy period
+           to its busy time. */
+
+        busy_time[server] += sim_time - time_busy_since[server];
+        set_idle(server);
+        --num_busy;
+    }
+
+    else {
+
+        /* The queue is nonempty, so the first customer in queue begins
+           service with this server.  Update the total delay accumulator. */
+
+        --num_in_q;
+        total_of_delays += sim_time - time_arrival[q_head++ & (RING_SIZE - 1)];
+        ++num_custs_delayed;
+        time_completion[server] = sim_time + expon(mean_service);
+        heap_push(server);
+    }
+}
+
+
+int find_idle_server(void)  /* Return the lowest-numbered idle server, or -1
+                               if all are busy. */
+{
+    int w;
+
+    /* The summary has a bit per word with any idle server, so two
+       find-first-set instructions locate the server. */
+
+    if (idle_summary == 0)
+        return -1;
+    w = __builtin_ctzll(idle_summary);
+    return 64 * w + __builtin_ctzll(idle_words[w]);
+}
+
+
+void set_idle(int server)  /* Mark server idle. */
+{
+    idle_words[server / 64] |= (uint64_t) 1 << (server % 64);
+    idle_summary            |= (uint64_t) 1 << (server / 64);
+}
+
+
+void set_busy(int server)  /* Mark server busy. */
+{
+    idle_words[server / 64] &= ~((uint64_t) 1 << (server % 64));
+    if (idle_words[server / 64] == 0)
+        idle_summary &= ~((uint64_t) 1 << (server / 64));
+}
+
+
+void start_service(int server)  /* Start a service with an idle server. */
+{
+    set_busy(server);
+    ++num_busy;
+    time_busy_since[server] = sim_time;
+    time_completion[server] = sim_time + expon(mean_service);
+    heap_push(server);
+}
+
+
+void heap_push(int server)  /* Add a server's completion to the heap. */
+{
+    int i;
+
+    /* Sift the new entry up from the bottom of the binary heap. */
+
+    for (i = ++heap_size; i > 1 &&
+         time_completion[heap[i / 2]] > time_completion[server]; i /= 2)
+        heap[i] = heap[i / 2];
+    heap[i] = server;
+}
+
+
+void heap_pop(void)  /* Remove the earliest completion from the heap. */
+{
+    int   i, child, last;
+
+    /* Sift the last entry down from the top of the binary heap. */
+
+    last = heap[heap_size--];
+    for (i = 1; (child = 2 * i) <= heap_size; i = child) {
+        if (child < heap_size &&
+            time_completion[heap[child + 1]] < time_completion[heap[child]])
+            ++child;
+        if (time_completion[heap[child]] >= time_completion[last])
+            break;
+        heap[i] = heap[child];
+    }
+    heap[i] = last;
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    int    i;
+    float  u, u_min, u_max;
+    double a, p_wait;
+
+    /* Close the busy periods in progress, so that every server's busy time
+       runs to the end of the simulation. */
+
+    for (i = 0; i < num_servers; ++i)
+        if (!(idle_words[i / 64] >> (i % 64) & 1)) {
+            busy_time[i]      += sim_time - time_busy_since[i];
+            time_busy_since[i] = sim_time;
+        }
+    u_min = 1.0;
+    u_max = 0.0;
+    for (i = 0; i < num_servers; ++i) {
+        u = busy_time[i] / sim_time;
+        if (u < u_min)
+            u_min = u;
+        if (u > u_max)
+            u_max = u;
+    }
+
+    /* Compute and write estimates of desired measures of performance. */
+
+    fprintf(outfile, "\n\nAverage delay in queue%11.3f minutes\n\n",
+            total_of_delays / num_custs_delayed);
+    fprintf(outfile, "Average number in queue%10.3f\n\n",
+            area_num_in_q / sim_time);
+    fprintf(outfile, "Average busy servers%13.3f\n\n",
+            area_num_busy / sim_time);
+    fprintf(outfile, "Server utilization%15.3f  (lowest%7.3f, highest%7.3f)",
+            area_num_busy / sim_time / num_servers, u_min, u_max);
+    fprintf(outfile, "\n\nTime simulation ended%12.3f minutes\n\n", sim_time);
+
+    /* Write the exact steady-state values from the Erlang C formula, when the
+       system is stable. */
+
+    a = (double) mean_service / mean_interarrival;
+    if (a < num_servers) {
+        p_wait = erlang_c(num_servers, a);
+        fprintf(outfile, "Steady-state values (Erlang C)\n\n");
+        fprintf(outfile, "Probability of delay%13.3f\n\n", p_wait);
+        fprintf(outfile, "Average delay in queue%11.3f minutes\n\n",
+                p_wait * mean_service / (num_servers - a));
+        fprintf(outfile, "Server utilization%15.3f\n", a / num_servers);
+    }
+
+    /* Write the utilization of each server. */
+
+    fprintf(outfile, "\nServer  Utilization");
+    for (i = 0; i < num_servers; ++i)
+        fprintf(outfile, "%s%6d%13.3f", i % 4 == 0 ? "\n" : "   ", i + 1,
+                busy_time[i] / sim_time);
+    fprintf(outfile, "\n");
+}
+
+
+void update_time_avg_stats(void)  /* Update area accumulators for time-average
+                                     statistics. */
+{
+    float time_since_last_event;
+
+    /* Compute time since last event, and update last-event-time marker. */
+
+    time_since_last_event = sim_time - time_last_event;
+    time_last_event       = sim_time;
+
+    /* Update area under number-in-queue function. */
+
+    area_num_in_q += num_in_q * time_since_last_event;
+
+    /* Update area under number-of-busy-servers function. */
+
+    area_num_busy += num_busy * time_since_last_event;
+}
+
+
+float expon(float mean)  /* Exponential variate generation function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrand(1));
+}
+
+
+double erlang_c(int c, double a)  /* Return the probability that an arrival
+                                     waits in an M/M/c queue with offered load
+                                     a (Erlang C formula). */
+{
+    int    k;
+    double b;
+
+    /* Compute the Erlang B blocking probability by its stable recursion, and
+       convert it to Erlang C. */
+
+    b = 1.0;
+    for (k = 1; k <= c; ++k)
+        b = a * b / (k + a * b);
+    return c * b / (c - a * (1.0 - b));
+}
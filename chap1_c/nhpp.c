@@ -0,0 +1,223 @@
+/* Nonstationary Poisson arrival processes.  See nhpp.h for usage. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "nhpp.h"     /* Header file for this module. */
+
+static int    locate(struct nhpp *p, double offset);
+static double piece_end(struct nhpp *p, int i);
+static double rate_at(struct nhpp *p, int i, double offset);
+static double area(struct nhpp *p, int i, double from, double to);
+
+
+int nhpp_read(FILE *infile, struct nhpp *p)  /* Read a rate table. */
+{
+    int i, last;
+
+    if (fscanf(infile, "%d %d %d %lf", &p->num_points, &p->linear, &p->method,
+               &p->period) != 4 || p->num_points < 1)
+        return -1;
+    p->t        = malloc((p->num_points + 1) * sizeof(double));
+    p->rate     = malloc((p->num_points + 1) * sizeof(double));
+    p->cum      = malloc((p->num_points + 1) * sizeof(double));
+    p->majorant = malloc((p->num_points + 1) * sizeof(double));
+    for (i = 0; i < p->num_points; ++i)
+        if (fscanf(infile, "%lf %lf", &p->t[i], &p->rate[i]) != 2 ||
+            p->rate[i] < 0.0 || (i > 0 && p->t[i] <= p->t[i - 1]))
+            return -1;
+    last = p->num_points - 1;
+    if (p->t[0] != 0.0 || (p->period > 0.0 && p->t[last] != p->period) ||
+        (p->period > 0.0 && last == 0))
+        return -1;
+
+    /* Compute the cumulative rate at each point, and the majorant of each
+       piece.  The piece after the last point, used only without a period, has
+       the constant rate of the last point. */
+
+    p->cum[0] = 0.0;
+    for (i = 0; i < last; ++i) {
+        p->majorant[i] = p->linear && p->rate[i + 1] > p->rate[i] ?
+                         p->rate[i + 1] : p->rate[i];
+        p->cum[i + 1]  = p->cum[i] + area(p, i, p->t[i], p->t[i + 1]);
+    }
+    p->majorant[last] = p->rate[last];
+
+    p->piece          = 0;
+    p->num_candidates = 0;
+    p->num_arrivals   = 0;
+    return 0;
+}
+
+
+double nhpp_next(struct nhpp *p, double time, int stream)  /* Generate the
+                                                              next arrival. */
+{
+    int    i, last;
+    double base, offset, end, mass, remaining, r, slope, x;
+
+    last = p->num_points - 1;
+
+    /* Split the time into the start of its period and the offset within it. */
+
+    base = 0.0;
+    if (p->period > 0.0) {
+        if (p->cum[last] == 0.0)
+            return 1.0e+30;
+        base = floor(time / p->period) * p->period;
+    }
+    offset = time - base;
+    i      = locate(p, offset);
+
+    if (p->method == NHPP_INVERSION) {
+
+        /* Invert the cumulative rate function: the next arrival is where it
+           has grown by an exponential amount with mean 1 from its value at
+           the current time. */
+
+        ++p->num_candidates;
+        remaining = -log(lcgrand(stream));
+        for (;;) {
+            end  = piece_end(p, i);
+            mass = i == last ? (p->rate[last] > 0.0 ? 1.0e+300 : 0.0) :
+                   area(p, i, offset, end);
+            if (remaining <= mass) {
+
+                /* The arrival falls in this piece.  Solve
+                   r x + slope x^2 / 2 = remaining for x in a form that is
+                   stable when the slope is small. */
+
+                r     = rate_at(p, i, offset);
+                slope = p->linear && i < last ? (p->rate[i + 1] - p->rate[i]) /
+                        (p->t[i + 1] - p->t[i]) : 0.0;
+                x     = 2.0 * remaining /
+                        (r + sqrt(r * r + 2.0 * slope * remaining));
+                p->piece = i;
+                ++p->num_arrivals;
+                return base + offset + x;
+            }
+            if (i == last)
+                return 1.0e+30;  /* The rate is zero from here on. */
+            remaining -= mass;
+            offset     = end;
+            if (++i == last && p->period > 0.0) {
+
+                /* Wrap around to the next period, skipping whole periods
+                   that the remaining amount covers. */
+
+                base  += p->period * (1.0 + floor(remaining / p->cum[last]));
+                remaining = fmod(remaining, p->cum[last]);
+                offset = 0.0;
+                i      = 0;
+            }
+        }
+    }
+
+    /* Thin a Poisson process whose rate is the majorant of the current
+       piece.  Candidates that would fall beyond the end of the piece are
+       discarded and generation restarts at the end of the piece, which the
+       lack of memory of the exponential distribution allows. */
+
+    for (;;) {
+        end = piece_end(p, i);
+        if (p->majorant[i] > 0.0) {
+            ++p->num_candidates;
+            offset += -log(lcgrand(stream)) / p->majorant[i];
+            if (offset < end) {
+
+                /* Accept the candidate with probability rate / majorant,
+                   which needs no random number on a flat piece. */
+
+                r = rate_at(p, i, offset);
+                if (r >= p->majorant[i] ||
+                    lcgrand(stream) * p->majorant[i] <= r) {
+                    p->piece = i;
+                    ++p->num_arrivals;
+                    return base + offset;
+                }
+                continue;
+            }
+        }
+        if (i == last)
+            return 1.0e+30;  /* The rate is zero from here on. */
+        offset = end;
+        if (++i == last && p->period > 0.0) {
+            base  += p->period;
+            offset = 0.0;
+            i      = 0;
+        }
+    }
+}
+
+
+double nhpp_expected(struct nhpp *p, double time)  /* Return the expected
+                                                      number of arrivals in
+                                                      (0, time]. */
+{
+    int    i, last;
+    double base, offset;
+
+    last = p->num_points - 1;
+    base = 0.0;
+    if (p->period > 0.0)
+        base = floor(time / p->period);
+    offset = time - base * p->period;
+    i      = locate(p, offset);
+    return base * p->cum[last] + p->cum[i] + area(p, i, p->t[i], offset);
+}
+
+
+void nhpp_free(struct nhpp *p)  /* Free a rate table. */
+{
+    free(p->t);
+    free(p->rate);
+    free(p->cum);
+    free(p->majorant);
+}
+
+
+static int locate(struct nhpp *p, double offset)  /* Return the piece holding
+                                                     offset. */
+{
+    int i, last;
+
+    /* Arrival times mostly increase, so start from the piece of the last
+       arrival. */
+
+    last = p->num_points - 1;
+    i    = p->piece;
+    if (p->t[i] > offset)
+        i = 0;
+    while (i < last && p->t[i + 1] <= offset)
+        ++i;
+    if (i == last && p->period > 0.0)
+        i = last - 1;  /* offset is the end of the period. */
+    p->piece = i;
+    return i;
+}
+
+
+static double piece_end(struct nhpp *p, int i)  /* Return the end of piece
+                                                   i. */
+{
+    return i < p->num_points - 1 ? p->t[i + 1] : 1.0e+300;
+}
+
+
+static double rate_at(struct nhpp *p, int i, double offset)  /* Return the
+                                                  rate at offset in piece i. */
+{
+    if (!p->linear || i == p->num_points - 1)
+        return p->rate[i];
+    return p->rate[i] + (p->rate[i + 1] - p->rate[i]) * (offset - p->t[i]) /
+                        (p->t[i + 1] - p->t[i]);
+}
+
+
+static double area(struct nhpp *p, int i, double from, double to)  /* Return
+                                        the area under piece i from "from" to
+                                        "to". */
+{
+    return 0.5 * (rate_at(p, i, from) + rate_at(p, i, to)) * (to - from);
+}
@@ -0,0 +1,49 @@
+/* Nonstationary Poisson arrival processes with piecewise-constant or
+   piecewise-linear rate functions.  A rate table is a list of points
+   (t_0 = 0, r_0), (t_1, r_1), ..., (t_n, r_n) with increasing times.  The
+   rate is r_i on [t_i, t_i+1) when the table is piecewise constant, and is
+   interpolated linearly between the points when it is piecewise linear.  If
+   the table has a period, the rate function repeats with that period, which
+   must equal t_n; otherwise the rate stays r_n after t_n.  Arrival times are
+   generated either by inverting the cumulative rate function (one random
+   number per arrival), or by thinning with a majorant that is constant on
+   each piece and equal to the larger rate at its ends, so that candidates
+   are rejected only under a sloping piece or past the end of a piece.  This
+   file (named nhpp.h) should be included in any program using these
+   functions by executing
+       #include "nhpp.h"
+   before referencing the functions.
+
+   Usage:
+       nhpp_read(infile, &p)        reads "num_points linear method period"
+                                    (linear 0 or 1, method NHPP_INVERSION or
+                                    NHPP_THINNING, period 0 for none) and then
+                                    num_points lines "time rate", and returns
+                                    0, or -1 if the table is invalid,
+       nhpp_next(&p, t, stream)     returns the time of the next arrival after
+                                    time t, using random-number stream
+                                    "stream",
+       nhpp_expected(&p, t)         returns the expected number of arrivals in
+                                    (0, t], and
+       nhpp_free(&p)                frees the table. */
+
+#ifndef NHPP_H
+#define NHPP_H
+
+#include <stdio.h>
+
+#define NHPP_INVERSION 0  /* Generation methods. */
+#define NHPP_THINNING  1
+
+struct nhpp {
+    int     num_points, linear, method, piece;
+    double  period, *t, *rate, *cum, *majorant;
+    long    num_candidates, num_arrivals;
+};
+
+int    nhpp_read(FILE *infile, struct nhpp *p);
+double nhpp_next(struct nhpp *p, double time, int stream);
+double nhpp_expected(struct nhpp *p, double time);
+void   nhpp_free(struct nhpp *p);
+
+#endif
@@ -0,0 +1,45 @@
+/* Fixed-capacity pool allocator.  See pool.h for usage. */
+
+#include <stdlib.h>
+#include "pool.h"  /* Header file for this module. */
+
+
+int pool_init(struct pool *p, size_t item_size, long capacity)  /* Allocate
+                                                                   a pool. */
+{
+    size_t size;
+
+    /* Round the item size up to a power of two if it is smaller than a cache
+       line, and to a whole number of lines otherwise. */
+
+    if (item_size < sizeof(struct pool_item))
+        item_size = sizeof(struct pool_item);
+    if (item_size < POOL_LINE) {
+        for (size = sizeof(struct pool_item); size < item_size; size *= 2)
+            ;
+        item_size = size;
+    }
+    else
+        item_size = (item_size + POOL_LINE - 1) / POOL_LINE * POOL_LINE;
+
+    /* Allocate the block on a cache-line boundary, rounding its size up to a
+       whole number of lines as aligned_alloc requires. */
+
+    size = (item_size * (capacity > 0 ? capacity : 1) + POOL_LINE - 1) /
+           POOL_LINE * POOL_LINE;
+    p->base = aligned_alloc(POOL_LINE, size);
+    if (p->base == NULL)
+        return -1;
+    p->item_size   = item_size;
+    p->capacity    = capacity;
+    p->peak_in_use = 0;
+    pool_reset(p);
+    return 0;
+}
+
+
+void pool_destroy(struct pool *p)  /* Free a pool. */
+{
+    free(p->base);
+    p->base = NULL;
+}
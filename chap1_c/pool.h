@@ -0,0 +1,75 @@
+/* Fixed-capacity pool allocator for simulation entities (customer records,
+   event nodes).  A pool is one cache-line-aligned block of equal-sized items,
+   allocated once.  Items are handed out first from a free list of returned
+   items and then in address order from the untouched part of the block, so
+   pool_alloc and pool_free take constant time and pool_reset, which returns
+   every item at once, takes constant time as well.  Items are rounded up in
+   size so that no item smaller than a cache line straddles two lines.  This
+   file (named pool.h) should be included in any program using these functions
+   by executing
+       #include "pool.h"
+   before referencing the functions.
+
+   Usage:
+       pool_init(&p, item_size, capacity)  allocates the block, and returns 0,
+                                           or -1 if it cannot,
+       pool_alloc(&p)                      returns an item, or NULL if all
+                                           capacity items are in use,
+       pool_free(&p, item)                 returns an item to the pool,
+       pool_reset(&p)                      returns all items to the pool, e.g.,
+                                           in initialize(), and
+       pool_destroy(&p)                    frees the block. */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+#define POOL_LINE 64  /* Cache line size, in bytes. */
+
+struct pool_item {  /* Link of a free item, kept in the item itself. */
+    struct pool_item *next;
+};
+
+struct pool {
+    char             *base;       /* The block of items. */
+    struct pool_item *free_list;  /* Items returned by pool_free. */
+    size_t            item_size;
+    long              capacity, num_fresh, num_in_use, peak_in_use;
+};
+
+int  pool_init(struct pool *p, size_t item_size, long capacity);
+void pool_destroy(struct pool *p);
+
+static inline void *pool_alloc(struct pool *p)  /* Allocate an item. */
+{
+    struct pool_item *item;
+
+    if (p->free_list != NULL) {
+        item         = p->free_list;
+        p->free_list = item->next;
+    }
+    else if (p->num_fresh < p->capacity)
+        item = (struct pool_item *) (p->base + p->num_fresh++ * p->item_size);
+    else
+        return NULL;
+    if (++p->num_in_use > p->peak_in_use)
+        p->peak_in_use = p->num_in_use;
+    return item;
+}
+
+static inline void pool_free(struct pool *p, void *item)  /* Free an item. */
+{
+    ((struct pool_item *) item)->next = p->free_list;
+    p->free_list                      = item;
+    --p->num_in_use;
+}
+
+static inline void pool_reset(struct pool *p)  /* Free all items. */
+{
+    p->free_list  = NULL;
+    p->num_fresh  = 0;
+    p->num_in_use = 0;
+}
+
+#endif
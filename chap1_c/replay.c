@@ -0,0 +1,71 @@
+/* Memory-mapped trace-driven input.  See replay.h for usage. */
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "replay.h"  /* Header file for this module. */
+
+const double *replay_data;
+long          replay_num_records, replay_stride, replay_arrival_next,
+              replay_service_next[REPLAY_STATION_LIMIT + 1];
+double        replay_time_last_arrival;
+
+static void   *replay_map;
+static size_t  replay_map_size;
+
+
+int replay_open(const char *path, int num_services)  /* Map a replay file. */
+{
+    int                   fd, i;
+    struct stat           st;
+    struct replay_header *header;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        fprintf(stderr, "Cannot open replay file %s\n", path);
+        return -1;
+    }
+    replay_map_size = st.st_size;
+    replay_map = replay_map_size < sizeof(struct replay_header) ?
+                 MAP_FAILED :
+                 mmap(NULL, replay_map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (replay_map == MAP_FAILED) {
+        fprintf(stderr, "Cannot map replay file %s\n", path);
+        return -1;
+    }
+
+    /* Check the header against the file size and the number of stations. */
+
+    header        = replay_map;
+    replay_stride = 1 + header->num_services;
+    if (header->magic != REPLAY_MAGIC || header->version != REPLAY_VERSION ||
+        header->num_services < (uint32_t) num_services ||
+        header->num_services > REPLAY_STATION_LIMIT ||
+        sizeof(struct replay_header) + header->num_records * replay_stride *
+        sizeof(double) > replay_map_size) {
+        fprintf(stderr, "%s is not a replay file with %d service times\n",
+                path, num_services);
+        munmap(replay_map, replay_map_size);
+        return -1;
+    }
+
+    /* The records are read once, front to back. */
+
+    madvise(replay_map, replay_map_size, MADV_SEQUENTIAL);
+    replay_data              = (const double *) (header + 1);
+    replay_num_records       = header->num_records;
+    replay_arrival_next      = 0;
+    replay_time_last_arrival = 0.0;
+    for (i = 0; i <= REPLAY_STATION_LIMIT; ++i)
+        replay_service_next[i] = 0;
+    return 0;
+}
+
+
+void replay_close(void)  /* Unmap the replay file. */
+{
+    munmap(replay_map, replay_map_size);
+}
@@ -0,0 +1,126 @@
+/* Trace-driven input for the queueing models.  A replay file holds measured
+   arrival timestamps and service times, and is memory-mapped and read in
+   place, so that arrivals and services are streamed from it without copying
+   or parsing.  The file is a struct replay_header followed by num_records
+   records, each of 1 + num_services doubles: the arrival time of a customer
+   and its service time at each station.  mkreplay converts a text file of such
+   records into this format.  This file (named replay.h) should be included in
+   any program using these functions by executing
+       #include "replay.h"
+   before referencing the functions.  The models use the hooks at the end of
+   this file, which expand to the synthetic draws unless compiled with
+   -DREPLAY.
+
+   Usage:
+       replay_open(path, num_services)  maps the file and returns 0, or
+                                        returns -1 (with a message on stderr)
+                                        if it cannot, or if the file has fewer
+                                        than num_services service times,
+       replay_interarrival()            returns the time from the previous
+                                        arrival (or from 0) to the next one,
+                                        or 1.0e+30 when the trace is exhausted,
+       replay_service(station)          returns the service time at station
+                                        (1, 2, ...) of the next customer to
+                                        begin service there; customers begin
+                                        service at each station in arrival
+                                        order,
+       replay_align()                   makes the next customer to arrive the
+                                        next to begin service at every
+                                        station, for a new replication whose
+                                        first customer is the next in the
+                                        trace (the customers left in the
+                                        system, and the arrival pending, at
+                                        the end of the previous replication
+                                        are skipped), and
+       replay_close()                   unmaps the file. */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#define REPLAY_MAGIC        0x52504c59UL  /* "YLPR" in little-endian order. */
+#define REPLAY_VERSION      1
+#define REPLAY_STATION_LIMIT 8
+
+struct replay_header {  /* File header. */
+    uint32_t magic, version, num_services, reserved;
+    uint64_t num_records;
+};
+
+extern const double *replay_data;
+extern long          replay_num_records, replay_stride, replay_arrival_next,
+                     replay_service_next[REPLAY_STATION_LIMIT + 1];
+extern double        replay_time_last_arrival;
+
+int  replay_open(const char *path, int num_services);
+void replay_close(void);
+
+static inline float replay_interarrival(void)  /* Return the next interarrival
+                                                  time from the trace. */
+{
+    double time_arrival, gap;
+
+    if (replay_arrival_next >= replay_num_records)
+        return 1.0e+30;
+    time_arrival = replay_data[replay_arrival_next++ * replay_stride];
+    gap          = time_arrival - replay_time_last_arrival;
+    replay_time_last_arrival = time_arrival;
+    return gap;
+}
+
+static inline void replay_align(void)  /* Pair the next arrival with the
+                                         next services. */
+{
+    int i;
+
+    for (i = 0; i <= REPLAY_STATION_LIMIT; ++i)
+        replay_service_next[i] = replay_arrival_next;
+}
+
+static inline float replay_service(int station)  /* Return the next service
+                                                    time at station. */
+{
+    return replay_data[replay_service_next[station]++ * replay_stride +
+                       station];
+}
+
+/* Hooks for the models: REPLAY_OPEN maps the trace (stopping the simulation
+   if it cannot), REPLAY_ALIGN starts a replication at the next customer of
+   the trace, REPLAY_ARRIVAL and REPLAY_SERVICE replace the draw given as
+   their last argument by the next value from the trace, REPLAY_EXHAUSTED
+   stops the simulation with exit code 4 if the trace has run out of
+   arrivals (used when the event list is empty, which it then is), and
+   REPLAY_REPORT notes the trace in the report heading. */
+
+#ifdef REPLAY
+#define REPLAY_OPEN(path, num_services) \
+    do { if (replay_open(path, num_services) < 0) exit(3); } while (0)
+#define REPLAY_CLOSE()                 replay_close()
+#define REPLAY_ALIGN()                 replay_align()
+#define REPLAY_ARRIVAL(draw)           replay_interarrival()
+#define REPLAY_SERVICE(station, draw)  replay_service(station)
+#define REPLAY_EXHAUSTED(outfile, time) \
+    do { \
+        if (replay_arrival_next >= replay_num_records) { \
+            fprintf(outfile, "\nReplay trace exhausted after %ld customers" \
+                    " at time %f", replay_num_records, time); \
+            exit(4); \
+        } \
+    } while (0)
+#define REPLAY_REPORT(outfile, path) \
+    fprintf(outfile, "Replayed from %s (%ld customers)\n\n", path, \
+            replay_num_records)
+#else
+#define REPLAY_OPEN(path, num_services)
+#define REPLAY_CLOSE()
+#define REPLAY_ALIGN()
+#define REPLAY_ARRIVAL(draw)           (draw)
+#define REPLAY_SERVICE(station, draw)  (draw)
+#define REPLAY_EXHAUSTED(outfile, time)
+#define REPLAY_REPORT(outfile, path)
+#endif
+
+#endif
@@ -0,0 +1,134 @@
+/* Next-event simulation engine with the event types fixed at compile time.
+   A model is a class derived from sim::engine<Model, Event1, ..., EventN>,
+   where the events are empty tag types, and it defines
+       void handle(Event1), ..., void handle(EventN)   the event functions,
+       void update_time_avg_stats(float time_since_last_event),
+       FILE *outfile                                   for error messages.
+   Event i of the list is event type i of the C models (counting from 0
+   here), and ties go to the lowest type, as in their timing functions.
+   Because the number of events is a template parameter, the event list is a
+   fixed-size array whose minimum the compiler can unroll, and dispatch is a
+   chain of comparisons against constants that calls the handlers directly,
+   so they can be inlined into the event loop.  The statistics are members of
+   the model, so their layout is fixed at compile time as well.  This file
+   (named sim.hpp) should be included in any model using the engine by
+   executing
+       #include "sim.hpp"
+   before referencing it.
+
+   Usage, within the model:
+       schedule<E>(t)   schedules the next event of type E at time t,
+       cancel<E>()      removes it from consideration,
+       index<E>         is the number of type E in the event list, and
+       step()           executes the next event and returns its number, so
+                        that a model runs, e.g., with
+                            while (num_custs_delayed < num_delays_required)
+                                step(); */
+
+#ifndef SIM_HPP
+#define SIM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
+#include "bench.h"  /* Header file for benchmark hooks. */
+
+namespace sim {
+
+template <class E, class... Events>
+struct index_of;  /* Position of E in Events. */
+
+template <class E, class... Rest>
+struct index_of<E, E, Rest...> : std::integral_constant<std::size_t, 0> {};
+
+template <class E, class First, class... Rest>
+struct index_of<E, First, Rest...>
+    : std::integral_constant<std::size_t, 1 + index_of<E, Rest...>::value> {};
+
+template <class Model, class... Events>
+class engine {
+public:
+    static constexpr std::size_t num_events = sizeof...(Events);
+
+    template <class E>
+    static constexpr std::size_t index = index_of<E, Events...>::value;
+
+    float sim_time, time_last_event;
+    std::array<float, num_events> time_next_event;
+
+    void start()  /* Set the clock to zero and empty the event list. */
+    {
+        sim_time        = 0.0;
+        time_last_event = 0.0;
+        time_next_event.fill(1.0e+30f);
+    }
+
+    template <class E>
+    void schedule(float time)  /* Schedule the next event of type E. */
+    {
+        time_next_event[index<E>] = time;
+    }
+
+    template <class E>
+    void cancel()  /* Eliminate the event of type E from consideration. */
+    {
+        time_next_event[index<E>] = 1.0e+30f;
+    }
+
+    std::size_t step()  /* Execute the next event and return its number. */
+    {
+        std::size_t i, next_event_type;
+        float       min_time_next_event = 1.0e+29f, time_since_last_event;
+
+        /* Determine the event type of the next event to occur. */
+
+        next_event_type = num_events;
+        for (i = 0; i < num_events; ++i)
+            if (time_next_event[i] < min_time_next_event) {
+                min_time_next_event = time_next_event[i];
+                next_event_type     = i;
+            }
+
+        /* Check to see whether the event list is empty. */
+
+        if (next_event_type == num_events) {
+            std::fprintf(model().outfile, "\nEvent list empty at time %f",
+                         sim_time);
+            std::exit(1);
+        }
+
+        /* Advance the simulation clock and update the time-average
+           statistical accumulators. */
+
+        sim_time              = min_time_next_event;
+        time_since_last_event = sim_time - time_last_event;
+        time_last_event       = sim_time;
+        BENCH_EVENT();
+        model().update_time_avg_stats(time_since_last_event);
+
+        /* Invoke the event function. */
+
+        dispatch(next_event_type, std::index_sequence_for<Events...>());
+        return next_event_type;
+    }
+
+private:
+    Model &model()  /* Return the model this engine runs. */
+    {
+        return static_cast<Model &>(*this);
+    }
+
+    template <std::size_t... I>
+    void dispatch(std::size_t i, std::index_sequence<I...>)  /* Call the
+                                                   handler of event type i. */
+    {
+        ((i == I ? (model().handle(Events()), true) : false) || ...);
+    }
+};
+
+}  // namespace sim
+
+#endif